@@ -0,0 +1,79 @@
+//  Boost MPL, index_of_v.hpp header file  -----------------------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/mpl/> for the library's home page.
+
+/** \file
+    \brief  Find the position of a type in a variadic type list
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions for `index_of_v`, a version of
+    `boost::mpl::find` adapted for C++11's variadic type lists.  The
+    (zero-based) position of the first type within the later ones is revealed
+    as a meta-function constant, or the length of the list if it's not there.
+ */
+
+#ifndef BOOST_MPL_INDEX_OF_V_HPP
+#define BOOST_MPL_INDEX_OF_V_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace boost
+{
+namespace mpl
+{
+
+
+//  Forward declarations  ----------------------------------------------------//
+
+//! Meta-function: a type and list of types -> where the type is in the list
+/** Given one type followed by several types submitted through a variadic
+    type-based template parameter, provide a compile-time constant with the
+    index of the first type's first occurrence in the following list.
+
+    The result is that the class inherits from a `std::size_t`-valued
+    Meta-function Integral-constant.  The constant is the zero-based position
+    of `Target` in `Corpus` if it's there, `sizeof...(Corpus)` otherwise.
+    (Combine with #contains_v to tell the cases apart without a comparison.)
+
+    \tparam Target  The type to look for.
+    \tparam Corpus  The list of types to search for `Target` in.  May be empty.
+ */
+template < typename Target, typename ...Corpus >
+struct index_of_v;
+
+
+//  Member-position metadata template partial specialization definitions  ---//
+
+//! Specialize `index_of_v` for the base case.
+template < typename T >
+struct index_of_v<T>
+    : std::integral_constant<std::size_t, 0u>
+{ };
+
+//! Specialize `index_of_v` for the recursive case.
+template < typename T, typename U, typename ...V >
+struct index_of_v<T, U, V...>
+    : std::integral_constant<
+          std::size_t,
+          std::is_same<T, U>::value ? 0u : 1u + index_of_v<T, V...>::value
+      >
+{ };
+
+
+}  // namespace mpl
+}  // namespace boost
+
+
+#endif  // BOOST_MPL_INDEX_OF_V_HPP
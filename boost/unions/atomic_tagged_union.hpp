@@ -0,0 +1,500 @@
+//  Boost Unions Library, atomic_tagged_union.hpp header file  ---------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  An atomic object holding a `tagged_union` of small, trivially
+            copyable types.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definition of `atomic_tagged_union`, which loads, stores,
+    exchanges, and compare-exchanges a whole `tagged_union` (its type and its
+    member together) without a mutex, and the `BOOST_UNIONS_NO_WIDE_CAS`
+    configuration macro.
+ */
+
+#ifndef BOOST_UNIONS_ATOMIC_TAGGED_UNION_HPP
+#define BOOST_UNIONS_ATOMIC_TAGGED_UNION_HPP
+
+#include "boost/unions/tagged_union.hpp"
+#include <boost/integer.hpp>
+#include <boost/variant/get.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+//  Configuration macros  ----------------------------------------------------//
+
+/** \def  BOOST_UNIONS_NO_WIDE_CAS
+    \brief  Define this to keep `atomic_tagged_union` from using a 16-byte
+            compare-and-swap instruction.
+
+    Otherwise, unions whose type and member fit in 16 bytes use `cmpxchg16b`
+    on x86-64 targets with GCC-style inline assembly.  (That instruction is
+    missing only from the very first x86-64 processors.)  When the compiler
+    targets AVX, whose processors make aligned 16-byte loads atomic, loads
+    use one instead, so readers don't write the cache line.  Elsewhere, or
+    with this defined, such unions use a sequence lock, as bigger ones always
+    do.
+ */
+//! \cond
+#if !defined( BOOST_UNIONS_NO_WIDE_CAS ) && defined( __x86_64__ ) && \
+ defined( __GNUC__ )
+#define BOOST_UNIONS_DETAIL_ATOMIC_CMPXCHG16B
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#endif
+//! \endcond
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // Ways to keep an image of a union atomically
+    enum class atomic_method  { word, double_word, sequence_lock };
+
+    // Which way "Size" image bytes are kept, and how many bytes that takes
+    template < std::size_t Size >
+    struct atomic_method_for
+    {
+        static constexpr  atomic_method  value = ( Size <= 8u &&
+         ATOMIC_LLONG_LOCK_FREE == 2 ) ? atomic_method::word :
+#ifdef BOOST_UNIONS_DETAIL_ATOMIC_CMPXCHG16B
+         ( Size <= 16u ) ? atomic_method::double_word :
+#endif
+         atomic_method::sequence_lock;
+        static constexpr  std::size_t  size = ( value == atomic_method::word ) ?
+         8u : ( value == atomic_method::double_word ) ? 16u : ( Size + 7u ) /
+         8u * 8u;
+    };
+
+    // Image bytes in one 64-bit atomic word
+    template < std::size_t Size, atomic_method Method >
+    class atomic_image
+    {
+        typedef unsigned long long  word_type;
+
+        static  auto  to_word( unsigned char const *image ) noexcept
+          -> word_type
+        {
+            word_type  result;
+
+            std::memcpy( &result, image, sizeof(result) );
+            return result;
+        }
+
+    public:
+        explicit  atomic_image( unsigned char const *image ) noexcept
+            : word_{ to_word(image) }
+        { }
+
+        void  load( unsigned char *image ) const noexcept
+        {
+            word_type const  w = word_.load( std::memory_order_seq_cst );
+
+            std::memcpy( image, &w, sizeof(w) );
+        }
+        void  store( unsigned char const *image ) noexcept
+        { word_.store( to_word(image), std::memory_order_seq_cst ); }
+        void  exchange( unsigned char const *image, unsigned char *old )
+          noexcept
+        {
+            word_type const  w = word_.exchange( to_word(image),
+             std::memory_order_seq_cst );
+
+            std::memcpy( old, &w, sizeof(w) );
+        }
+        bool  compare_exchange( unsigned char *expected, unsigned char const
+         *desired ) noexcept
+        {
+            word_type  e = to_word( expected );
+
+            if ( word_.compare_exchange_strong(e, to_word( desired ),
+             std::memory_order_seq_cst) )
+                return true;
+            std::memcpy( expected, &e, sizeof(e) );
+            return false;
+        }
+
+    private:
+        std::atomic<word_type>  word_;
+    };
+
+#ifdef BOOST_UNIONS_DETAIL_ATOMIC_CMPXCHG16B
+    // Image bytes in a 16-byte block, changed only by cmpxchg16b
+    template < std::size_t Size >
+    class atomic_image< Size, atomic_method::double_word >
+    {
+        struct alignas( 16 ) block_type
+        {
+            std::uint64_t  w[ 2 ];
+        };
+
+        // On failure, "expected" gets the block's value
+        static  bool  cmpxchg16b( block_type &where, std::uint64_t *expected,
+         std::uint64_t const *desired ) noexcept
+        {
+            bool  result;
+
+            __asm__ __volatile__( "lock cmpxchg16b %1\n\tsete %0"
+             : "=q"( result ), "+m"( where ), "+a"( expected[0] ),
+               "+d"( expected[1] )
+             : "b"( desired[0] ), "c"( desired[1] )
+             : "cc", "memory" );
+            return result;
+        }
+
+    public:
+        explicit  atomic_image( unsigned char const *image ) noexcept
+        { std::memcpy( block_.w, image, sizeof(block_.w) ); }
+
+        // Without AVX, a read is a compare-and-swap of zero with zero, which
+        // fails (leaving the block alone) or writes back the zero that's
+        // already there
+        void  load( unsigned char *image ) const noexcept
+        {
+#ifdef __AVX__
+            __m128i  b;
+
+            __asm__ __volatile__( "vmovdqa %1, %0" : "=x"( b ) : "m"( block_ )
+             : "memory" );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>(image), b );
+#else
+            std::uint64_t  e[ 2 ] = { 0u, 0u };
+
+            cmpxchg16b( block_, e, e );
+            std::memcpy( image, e, sizeof(e) );
+#endif
+        }
+        void  store( unsigned char const *image ) noexcept
+        {
+            std::uint64_t  old[ 2 ];
+
+            this->exchange( image, reinterpret_cast<unsigned char *>(old) );
+        }
+        void  exchange( unsigned char const *image, unsigned char *old )
+          noexcept
+        {
+            std::uint64_t  e[ 2 ], d[ 2 ];
+
+            this->load( reinterpret_cast<unsigned char *>(e) );
+            std::memcpy( d, image, sizeof(d) );
+            while ( !cmpxchg16b(block_, e, d) )
+                ;
+            std::memcpy( old, e, sizeof(e) );
+        }
+        bool  compare_exchange( unsigned char *expected, unsigned char const
+         *desired ) noexcept
+        {
+            std::uint64_t  e[ 2 ], d[ 2 ];
+
+            std::memcpy( e, expected, sizeof(e) );
+            std::memcpy( d, desired, sizeof(d) );
+            if ( cmpxchg16b(block_, e, d) )
+                return true;
+            std::memcpy( expected, e, sizeof(e) );
+            return false;
+        }
+
+    private:
+        mutable block_type  block_;
+    };
+#endif
+
+    // Image bytes in relaxed atomic words, guarded by a sequence count that's
+    // odd while a writer is at work
+    template < std::size_t Size >
+    class atomic_image< Size, atomic_method::sequence_lock >
+    {
+        typedef unsigned long long  word_type;
+        typedef unsigned            count_type;
+
+        static constexpr  std::size_t  words = Size / sizeof( word_type );
+
+        // Take the writer's side, returning the (even) count before
+        auto  lock() noexcept -> count_type
+        {
+            count_type  c = sequence_.load( std::memory_order_relaxed );
+
+            for ( ;; )
+                if ( c & 1u )
+                    c = sequence_.load( std::memory_order_relaxed );
+                else if ( sequence_.compare_exchange_weak(c, c + 1u,
+                 std::memory_order_acquire, std::memory_order_relaxed) )
+                    break;
+            std::atomic_thread_fence( std::memory_order_release );
+            return c;
+        }
+        void  unlock( count_type c ) noexcept
+        { sequence_.store( c + 2u, std::memory_order_release ); }
+
+        void  read( unsigned char *image ) const noexcept
+        {
+            for ( std::size_t  i = 0u ; i < words ; ++i )
+            {
+                word_type const  w = words_[ i ].load(
+                 std::memory_order_relaxed );
+
+                std::memcpy( image + i * sizeof(w), &w, sizeof(w) );
+            }
+        }
+        void  write( unsigned char const *image ) noexcept
+        {
+            for ( std::size_t  i = 0u ; i < words ; ++i )
+            {
+                word_type  w;
+
+                std::memcpy( &w, image + i * sizeof(w), sizeof(w) );
+                words_[ i ].store( w, std::memory_order_relaxed );
+            }
+        }
+
+    public:
+        explicit  atomic_image( unsigned char const *image ) noexcept
+            : sequence_{ 0u }
+        { this->write( image ); }
+
+        void  load( unsigned char *image ) const noexcept
+        {
+            for ( ;; )
+            {
+                count_type const  before = sequence_.load(
+                 std::memory_order_acquire );
+
+                if ( before & 1u )
+                    continue;
+                this->read( image );
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( sequence_.load(std::memory_order_relaxed) == before )
+                    break;
+            }
+        }
+        void  store( unsigned char const *image ) noexcept
+        {
+            count_type const  c = this->lock();
+
+            this->write( image );
+            this->unlock( c );
+        }
+        void  exchange( unsigned char const *image, unsigned char *old )
+          noexcept
+        {
+            count_type const  c = this->lock();
+
+            this->read( old );
+            this->write( image );
+            this->unlock( c );
+        }
+        bool  compare_exchange( unsigned char *expected, unsigned char const
+         *desired ) noexcept
+        {
+            unsigned char      current[ Size ];
+            count_type const   c = this->lock();
+
+            this->read( current );
+
+            bool const  result = !std::memcmp( current, expected, Size );
+
+            if ( result )
+                this->write( desired );
+            this->unlock( c );
+            if ( !result )
+                std::memcpy( expected, current, Size );
+            return result;
+        }
+
+    private:
+        std::atomic<count_type>  sequence_;
+        std::atomic<word_type>   words_[ words ];
+    };
+
+    // Builds a union holding the "T" whose bytes are at "bytes"
+    template < class Union, typename T >
+    auto  union_from_bytes( unsigned char const *bytes ) -> Union
+    {
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+        std::memcpy( &b, bytes, sizeof(T) );
+        return Union{ *reinterpret_cast<T const *>(&b) };
+    }
+
+    template < class Union >
+    auto  empty_union_from_bytes( unsigned char const * ) -> Union
+    { return Union{}; }
+}
+//! \endcond
+
+
+//  Atomic tagged union class template definition  ---------------------------//
+
+//! An atomic `tagged_union` of trivially copyable types
+/** Loads, stores, exchanges, and compare-exchanges a whole
+    `tagged_union<Types...>`, i.e. which type it holds and that member, as
+    one atomic step, all sequentially consistent.  The union is kept as a
+    compact image: the index in the smallest unsigned type that holds it, then
+    the member's bytes, with the rest zeroed.  When the image fits in 8 bytes
+    it is a `std::atomic` 64-bit word; when it fits in 16 and
+    `BOOST_UNIONS_NO_WIDE_CAS` allows, a 16-byte block changed only by a
+    double-width compare-and-swap; in either case no operation takes a lock.
+    Otherwise, writers take a sequence lock and readers retry whenever one got
+    in their way.
+
+    As with `std::atomic`, `compare_exchange` compares the images, i.e. the
+    member's bytes, padding included; a member type with padding can make it
+    fail for equal values (and it then gives the value found, so a retry
+    loop still finishes).
+
+    \tparam Types  The variant types.  Each must be trivially copyable.
+ */
+template < typename ...Types >
+class atomic_tagged_union
+{
+    static_assert( detail::all_of<std::is_trivially_copyable<Types>::value...
+     >::value, "Every type must be trivially copyable" );
+
+    typedef typename boost::uint_value_t<sizeof...( Types )>::least  tag_type;
+    typedef detail::atomic_method_for<sizeof( tag_type ) + detail::max_of(
+     0u, sizeof(Types)...)>  method_type;
+
+public:
+    //! The type of the values held
+    typedef tagged_union<Types...>  value_type;
+
+    //! Whether no operation takes a lock
+    static constexpr  bool  is_always_lock_free = method_type::value !=
+     detail::atomic_method::sequence_lock;
+
+    //! Hold an empty union
+    atomic_tagged_union() noexcept
+        : image_{ make_image(value_type{}).bytes }
+    { }
+    //! Hold a copy of `value`
+    /** \throws  boost::bad_get  if `value` stores a pointer-to-self.
+     */
+    atomic_tagged_union( value_type const &value )
+        : image_{ make_image(value).bytes }
+    { }
+    //! Can't be copied, like `std::atomic`
+    atomic_tagged_union( atomic_tagged_union const & ) = delete;
+    //! Can't be copied, like `std::atomic`
+    auto  operator =( atomic_tagged_union const & ) -> atomic_tagged_union &
+      = delete;
+
+    //! Read the union
+    auto  load() const -> value_type
+    {
+        image_type  i;
+
+        image_.load( i.bytes );
+        return from_image( i );
+    }
+    //! Replace the union with a copy of `value`
+    /** \throws  boost::bad_get  if `value` stores a pointer-to-self; nothing is
+                 changed then.
+     */
+    void  store( value_type const &value )
+    { image_.store( make_image(value).bytes ); }
+    //! Replace the union with a copy of `value`, giving the old one
+    /** \throws  boost::bad_get  if `value` stores a pointer-to-self; nothing is
+                 changed then.
+     */
+    auto  exchange( value_type const &value ) -> value_type
+    {
+        image_type const  i = make_image( value );
+        image_type        old;
+
+        image_.exchange( i.bytes, old.bytes );
+        return from_image( old );
+    }
+    //! Replace the union with `desired` if it's the same as `expected`
+    /** Never fails spuriously, unlike `std::atomic`'s weak version.
+
+        \throws  boost::bad_get  if either argument stores a pointer-to-self;
+                 nothing is changed then.
+
+        \retval true   The union was the same as `expected`, and now holds a
+                       copy of `desired`.
+        \retval false  The union was different, and was copied to `expected`.
+     */
+    bool  compare_exchange( value_type &expected, value_type const &desired )
+    {
+        image_type        e = make_image( expected );
+        image_type const  d = make_image( desired );
+
+        if ( image_.compare_exchange(e.bytes, d.bytes) )
+            return true;
+        expected = from_image( e );
+        return false;
+    }
+
+private:
+    struct image_type
+    {
+        unsigned char  bytes[ method_type::size ];
+    };
+
+    static  auto  make_image( value_type const &value ) -> image_type
+    {
+        static std::size_t const  sizes[] = { sizeof(Types)..., 0u };
+
+        if ( value.storing_pointer_to_self() )
+            throw bad_get{};
+
+        image_type      result = {};
+        tag_type const  tag = ( value.stored_index() < sizeof...(Types) ) ?
+         value.stored_index() : sizeof...( Types );
+
+        std::memcpy( result.bytes, &tag, sizeof(tag) );
+        if ( tag < sizeof...(Types) )
+            std::memcpy( result.bytes + sizeof(tag), value.data(), sizes[tag] );
+        return result;
+    }
+    static  auto  from_image( image_type const &i ) -> value_type
+    {
+        static auto (* const  table[])( unsigned char const * ) -> value_type
+         = { &detail::union_from_bytes<value_type, Types>...,
+         &detail::empty_union_from_bytes<value_type> };
+        tag_type  tag;
+
+        std::memcpy( &tag, i.bytes, sizeof(tag) );
+        return table[ tag ]( i.bytes + sizeof(tag) );
+    }
+
+    // Member data
+    detail::atomic_image<method_type::size, method_type::value>  image_;
+};
+
+//! \cond
+template < typename ...Types >
+constexpr  bool  atomic_tagged_union<Types...>::is_always_lock_free;
+//! \endcond
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_ATOMIC_TAGGED_UNION_HPP
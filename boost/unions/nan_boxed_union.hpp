@@ -0,0 +1,544 @@
+//  Boost Unions Library, nan_boxed_union.hpp header file  -------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A tagged-union of small scalars, packed into the NaN space of a
+            `double`.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions of `nan_boxed_union`, a counterpart
+    of `tagged_union` for the value types of dynamically-typed interpreters: a
+    `double`, integers and `float`s of up to 32 bits, `bool`, and object
+    pointers.  The whole union is one 64-bit word.  A `double` is stored as
+    itself, and everything else is stored in the payload of a NaN pattern that
+    no stored `double` uses.  The usual access functions, a `visit`, and traits
+    specializations are also provided.
+ */
+
+#ifndef BOOST_UNIONS_NAN_BOXED_UNION_HPP
+#define BOOST_UNIONS_NAN_BOXED_UNION_HPP
+
+#include "boost/mpl/contains_v.hpp"
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/mpl/type_at_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/variant_traits.hpp"
+#include "boost/utility/index_sequence11.hpp"
+#include <boost/assert.hpp>
+#include <boost/variant/get.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // The boxed words are the negative quiet NaNs: sign, exponent, and quiet
+    // bits all set.  Then come four bits of state index and 47 of payload.
+    std::uint64_t const  nan_box_prefix = 0xFFF8000000000000u;
+    std::uint64_t const  nan_box_canonical = 0x7FF8000000000000u;
+    std::size_t const    nan_box_index_shift = 47u;
+    std::uint64_t const  nan_box_payload_mask = ( std::uint64_t(1u) <<
+     nan_box_index_shift ) - 1u;
+
+    // How a non-double type is put into, and taken out of, the payload
+    template < typename T, class Enable = void >
+    struct nan_box_codec
+    {
+        static constexpr  bool  boxable = false;
+    };
+
+    template < typename T >
+    struct nan_box_codec<T, typename std::enable_if<std::is_integral<T>::value
+     && (sizeof(T) <= 4u)>::type>
+    {
+        static constexpr  bool  boxable = true;
+
+        static  auto  encode( T value ) noexcept -> std::uint64_t
+        { return static_cast<typename std::make_unsigned<T>::type>( value ); }
+
+        static  auto  decode( std::uint64_t payload ) noexcept -> T
+        {
+            return static_cast<T>( static_cast<typename std::make_unsigned<T>
+             ::type>(payload) );
+        }
+    };
+
+    template < >
+    struct nan_box_codec<bool>
+    {
+        static constexpr  bool  boxable = true;
+
+        static  auto  encode( bool value ) noexcept -> std::uint64_t
+        { return value; }
+
+        static  auto  decode( std::uint64_t payload ) noexcept -> bool
+        { return payload != 0u; }
+    };
+
+    template < >
+    struct nan_box_codec<float>
+    {
+        static constexpr  bool  boxable = true;
+
+        static  auto  encode( float value ) noexcept -> std::uint64_t
+        {
+            std::uint32_t  bits;
+
+            std::memcpy( &bits, &value, sizeof(bits) );
+            return bits;
+        }
+
+        static  auto  decode( std::uint64_t payload ) noexcept -> float
+        {
+            std::uint32_t const  bits = static_cast<std::uint32_t>( payload );
+            float                value;
+
+            std::memcpy( &value, &bits, sizeof(value) );
+            return value;
+        }
+    };
+
+    template < typename T >
+    struct nan_box_codec<T *, typename std::enable_if<std::is_object<T>::value
+     >::type>
+    {
+        static constexpr  bool  boxable = true;
+
+        static  auto  encode( T *value ) noexcept -> std::uint64_t
+        {
+            std::uint64_t const  bits = reinterpret_cast<std::uintptr_t>(
+             value );
+
+            // Masking off high bits would give a different address
+            BOOST_ASSERT( !(bits & ~nan_box_payload_mask) );
+            return bits;
+        }
+
+        static  auto  decode( std::uint64_t payload ) noexcept -> T *
+        {
+            return reinterpret_cast<T *>( static_cast<std::uintptr_t>(payload)
+             );
+        }
+    };
+}
+//! \endcond
+
+
+//  NaN-boxed tagged union class template definition  ------------------------//
+
+//! Union-type of scalars packed into the unused NaN encodings of a `double`
+/** Works like `tagged_union` for types that fit in a 64-bit word, but needs no
+    separate tag.  A stored `double` keeps its own representation, except that
+    every NaN is stored as the one positive quiet NaN.  The negative quiet NaNs
+    are left free; in those, the 51 bits after the sign, exponent, and quiet
+    bits hold a four-bit state index and 47 bits of payload.  So copying a
+    union is a single register move, and an array of them is an array of
+    words.
+
+    Like `tagged_union`, pointers to (possibly cv-qualified) `nan_boxed_union`
+    are implicit variant types, just after `Types`, and there is an empty
+    state.
+
+    The access functions return the stored value by value, since most of the
+    variant types don't exist as objects inside the word.
+
+    \pre  Stored pointers must fit in 47 bits, as user-space addresses do on
+          the common 64-bit systems (x86-64 and AArch64 with 48-bit virtual
+          addresses), but not kernel addresses or those from 5-level paging.
+          Storing one that doesn't is caught by `BOOST_ASSERT`.
+
+    \tparam Types  The types to be included in the union.  It may be empty, and
+                   may have at most eleven types.  Each must be `double`,
+                   `float`, `bool`, an integral type of at most 32 bits, or a
+                   pointer to a (possibly cv-qualified) object type.  Repeats
+                   are not flagged.
+ */
+template < typename ...Types >
+class nan_boxed_union
+{
+    static_assert( std::numeric_limits<double>::is_iec559 && (sizeof(double)
+     == sizeof(std::uint64_t)), "NaN-boxing needs IEEE-754 binary64 doubles" );
+    static_assert( detail::all_of<(std::is_same<Types, double>::value ||
+     detail::nan_box_codec<Types>::boxable)...>::value, "Each variant type "
+     "must be a double or fit within the payload of a NaN" );
+    static_assert( sizeof...(Types) + 4u < 16u, "Too many variant types" );
+
+public:
+    //! The type of the packed representation
+    typedef std::uint64_t  word_type;
+
+    //! Returns a list of the union's variant members' types.
+    static
+    auto  variant_types() noexcept
+      -> std::array<std::type_info const *, sizeof...(Types)>
+    { return { {&typeid(Types)...} }; }
+
+    //! Returns the index used by `stored_index` when no value is stored.
+    static constexpr
+    auto  empty_index() noexcept -> std::size_t
+    { return sizeof...(Types) + 4u; }
+    //! Returns the index `stored_index` uses for type `T`.
+    /** \returns  The index of `T` within `Types` if it's there, else
+                  `variant_size + 0` through `+ 3` for `nan_boxed_union *`,
+                  `nan_boxed_union const *`, `nan_boxed_union volatile *`, and
+                  `nan_boxed_union const volatile *`, respectively; otherwise
+                  `#empty_index()`.
+     */
+    template < typename T >
+    static constexpr
+    auto  index_of() noexcept -> std::size_t
+    {
+        return mpl::index_of_v<T, Types..., nan_boxed_union *,
+         nan_boxed_union const *, nan_boxed_union volatile *,
+         nan_boxed_union const volatile *>::value;
+    }
+
+    //! Default-construction, with no data
+    constexpr  nan_boxed_union() noexcept
+        : word_{ box(empty_index(), 0u) }
+    { }
+
+    //! Construction from a `double`, if that's a variant type
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<T, double>::value && mpl::contains_v<T, Types...>
+             ::value
+        >::type
+    >
+    nan_boxed_union( T that ) noexcept
+        : word_{ double_bits(that) }
+    { }
+    //! Construction from any other variant type
+    template <
+        typename T,
+        typename EnableIf = typename std::enable_if<
+            !std::is_same<T, double>::value && mpl::contains_v<T, Types...>
+             ::value
+        >::type,
+        typename = void
+    >
+    nan_boxed_union( T that ) noexcept
+        : word_{ box(index_of<T>(), detail::nan_box_codec<T>::encode(that)) }
+    { }
+    //! Construction by copying a pointer to self
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<nan_boxed_union, T>::value
+        >::type
+    >
+    nan_boxed_union( T const volatile *that ) noexcept
+        : word_{ box_pointer(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<nan_boxed_union, T>::value
+        >::type
+    >
+    nan_boxed_union( T volatile *that ) noexcept
+        : word_{ box_pointer(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<nan_boxed_union, T>::value
+        >::type
+    >
+    nan_boxed_union( T const *that ) noexcept
+        : word_{ box_pointer(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<nan_boxed_union, T>::value
+        >::type
+    >
+    nan_boxed_union( T *that ) noexcept
+        : word_{ box_pointer(that) }
+    { }
+
+    //! Returns the packed representation.
+    auto  word() const noexcept -> word_type
+    { return word_; }
+
+    //! Check the type of the value being stored, NULL if none
+    auto  stored_type() const noexcept -> std::type_info const *
+    {
+        static std::type_info const * const  types[] = {
+            &typeid(Types)..., &typeid(nan_boxed_union *),
+            &typeid(nan_boxed_union const *),
+            &typeid(nan_boxed_union volatile *),
+            &typeid(nan_boxed_union const volatile *), nullptr
+        };
+
+        return types[ stored_index() ];
+    }
+    //! Check the index of the value being stored, `empty_index()` if none
+    /** A word outside the boxed range is a `double`, so this is a single
+        comparison and a shift, with no memory access.
+     */
+    auto  stored_index() const noexcept -> std::size_t
+    {
+        return ( word_ >= detail::nan_box_prefix ) ? static_cast<std::size_t>(
+         (word_ >> detail::nan_box_index_shift) & 0x0Fu ) : index_of<double>();
+    }
+    //! Check if current value is a pointer-to-self type
+    bool  storing_pointer_to_self() const noexcept
+    {
+        return ( stored_index() >= sizeof...(Types) ) && ( stored_index() !=
+         empty_index() );
+    }
+
+protected:
+    //! Check for self-consistency
+    bool  invariant() const
+    { return stored_index() <= empty_index(); }
+
+private:
+    static constexpr
+    auto  box( std::size_t index, word_type payload ) noexcept -> word_type
+    {
+        return detail::nan_box_prefix | ( word_type(index) <<
+         detail::nan_box_index_shift ) | payload;
+    }
+
+    template < typename T >
+    static
+    auto  box_pointer( T *that ) noexcept -> word_type
+    {
+        return box( index_of<T *>(), detail::nan_box_codec<T *>::encode(that)
+         );
+    }
+
+    static
+    auto  double_bits( double that ) noexcept -> word_type
+    {
+        word_type  bits;
+
+        std::memcpy( &bits, &that, sizeof(bits) );
+        return ( that != that ) ? detail::nan_box_canonical : bits;
+    }
+
+    word_type  word_;
+};
+
+
+//  NaN-boxed union metadata template specialization definitions  ------------//
+
+//! Specialization of `variant_element` for `nan_boxed_union`s.
+template < std::size_t Index, typename ...Types >
+struct variant_element<Index, nan_boxed_union<Types...>>
+{
+    typedef typename mpl::type_at_v<Index, Types...>::type  type;
+};  // Note that any repeats are included!
+
+//! Specialization of `variant_size` for `nan_boxed_union`s.
+template < typename ...Types >
+struct variant_size<nan_boxed_union<Types...>>
+    : std::integral_constant<std::size_t, sizeof...(Types)>
+{ };  // Note that all repeats are included!
+
+
+//  NaN-boxed union template data extraction functions  ----------------------//
+
+//! \cond
+namespace detail
+{
+    template < typename T >
+    struct nan_unboxer
+    {
+        static  auto  get( std::uint64_t word ) noexcept -> T
+        { return nan_box_codec<T>::decode( word & nan_box_payload_mask ); }
+    };
+
+    template < >
+    struct nan_unboxer<double>
+    {
+        static  auto  get( std::uint64_t word ) noexcept -> double
+        {
+            double  value;
+
+            std::memcpy( &value, &word, sizeof(value) );
+            return value;
+        }
+    };
+}
+//! \endcond
+
+//! Extract the variant member of the given type from the given
+//! `nan_boxed_union`.
+/** Besides the types explicitly given in `Types`, a type that is a pointer to
+    cv-qualified `nan_boxed_union` may be used for `T`.  Unlike the
+    `tagged_union` versions, the stored value is returned by value, and there
+    is no pointer version.
+
+    \tparam T      The type of the desired variant member.  Must be explicitly
+                   provided.
+    \tparam Types  The variant types listed in `nu`'s type.  Should not be
+                   explicitly provided.  This variadic list may be empty.
+
+    \param[in] nu  The `nan_boxed_union` object to be accessed.
+
+    \throws  `boost::bad_get` if the wrong type is requested.
+
+    \returns  The stored value.
+ */
+template < typename T, typename ...Types >
+auto  gett( nan_boxed_union<Types...> const &nu ) -> T
+{
+    static_assert( nan_boxed_union<Types...>::template index_of<T>() !=
+     nan_boxed_union<Types...>::empty_index(), "The requested type isn't in "
+     "the union" );
+
+    if ( nu.stored_index() != nan_boxed_union<Types...>::template index_of<T>()
+     )
+        throw bad_get{};
+    return detail::nan_unboxer<T>::get( nu.word() );
+}
+
+//! Extract the variant member of the given index from the given
+//! `nan_boxed_union`.
+/** This accessor cannot be used to get the secret variants of type
+    `nan_boxed_union\<Types...\> CV *`.
+
+    \pre  `0 \<= Index \< #variant_size\<decltype(nu)\>\::value`
+
+    \tparam Index  The index of the desired variant member.  Must be explicitly
+                   provided.
+    \tparam Types  The variant types listed in `nu`'s type.  Should not be
+                   explicitly provided.  This variadic list may be empty.
+
+    \param[in] nu  The `nan_boxed_union` object to be accessed.
+
+    \throws  `boost::bad_get` if the wrong type is requested.
+
+    \returns  The stored value.
+ */
+template < std::size_t Index, typename ...Types >
+auto  get( nan_boxed_union<Types...> const &nu )
+ -> typename variant_element<Index, nan_boxed_union<Types...>>::type
+{
+    return gett<typename variant_element<Index, nan_boxed_union<Types...>>
+     ::type>( nu );
+}
+
+
+//  NaN-boxed union template visitation function  ----------------------------//
+
+//! \cond
+namespace detail
+{
+    template < typename R, typename Func, typename ...Types >
+    struct nan_box_dispatcher
+    {
+        typedef nan_boxed_union<Types...>  union_type;
+        typedef R (*thunk_type)( Func&&, std::uint64_t );
+
+        template < typename T >
+        static  R  call_state( std::true_type, Func&& visitor, std::uint64_t
+         word )
+        {
+            return static_cast<R>( std::forward<Func>(visitor)(
+             nan_unboxer<T>::get(word)) );
+        }
+
+        template < typename T >
+        static  R  call_state( std::false_type, Func&&, std::uint64_t )
+        { throw bad_get{}; }
+
+        template < std::size_t Index >
+        static  R  call( Func&& visitor, std::uint64_t word )
+        {
+            typedef typename mpl::type_at_v<Index, Types..., union_type *,
+             union_type const *, union_type volatile *, union_type const
+             volatile *>::type  state_type;
+
+            return call_state<state_type>( std::integral_constant<bool, (Index
+             < sizeof...(Types)) || visit_result_fits<R, Func,
+             state_type>::type::value>{}, std::forward<Func>(visitor), word );
+        }
+
+        static  R  call_empty( Func&&, std::uint64_t )
+        { throw bad_get{}; }
+
+        template < std::size_t ...Indices >
+        static  R  visit( index_sequence<Indices...>, Func&& visitor,
+         std::uint64_t word, std::size_t which )
+        {
+            static thunk_type const  thunks[] = {
+                &call<Indices>..., &call_empty
+            };
+
+            return thunks[ which ]( std::forward<Func>(visitor), word );
+        }
+    };
+}
+//! \endcond
+
+//! Call a function object with the active member of a `nan_boxed_union`.
+/** Works like the `tagged_union` version, but for a single union, and the
+    variant member is passed by value.  A stored pointer-to-self is passed
+    only if `visitor` accepts it.
+
+    \pre  `visitor` can be called with every one of `Types`.
+
+    \param visitor  The function object to call.
+    \param nu       The `nan_boxed_union` object whose member is passed on.
+
+    \throws  `boost::bad_get` if `nu` is empty, or stores a pointer-to-self
+             that `visitor` can't take.  Otherwise, anything `visitor` throws.
+
+    \returns  What `visitor` returns, converted to the common type of its
+              results over all of `Types`.
+ */
+template < typename Func, typename ...Types >
+auto  visit( Func&& visitor, nan_boxed_union<Types...> const &nu )
+  -> typename detail::visit_common_type<decltype( std::declval<Func>()(
+      std::declval<Types>()) )...>::type
+{
+    typedef typename detail::visit_common_type<decltype( std::declval<Func>()(
+     std::declval<Types>()) )...>::type  result_type;
+
+    return detail::nan_box_dispatcher<result_type, Func, Types...>::visit(
+     make_index_sequence<nan_boxed_union<Types...>::empty_index()>{},
+     std::forward<Func>(visitor), nu.word(), nu.stored_index() );
+}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_NAN_BOXED_UNION_HPP
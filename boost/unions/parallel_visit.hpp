@@ -0,0 +1,285 @@
+//  Boost Unions Library, parallel_visit.hpp header file  --------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Folding a visitor over a range of `tagged_union` objects on
+            several threads.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definition of `parallel_visit_reduce`, which splits a large
+    range of `tagged_union` objects into cache-sized chunks, visits them on
+    several threads with `visit_range`, each thread with its own copy of the
+    visitor and its own accumulator, and merges the accumulators at the end.
+ */
+
+#ifndef BOOST_UNIONS_PARALLEL_VISIT_HPP
+#define BOOST_UNIONS_PARALLEL_VISIT_HPP
+
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/union_policy.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // Whether a visited state is one of the pointers-to-self of "Union"
+    template < typename Union, typename U >
+    struct is_self_pointer
+        : std::integral_constant<bool, std::is_pointer<U>::value &&
+           std::is_same<typename std::remove_cv<typename std::remove_pointer<
+           U>::type>::type, Union>::value>
+    { };
+
+    // Passes each member to the visitor and folds the result into the
+    // accumulator.  Every variant member goes through, so "visit_range"
+    // checks that the visitor takes them; pointers-to-self go through only
+    // if the visitor takes them, so "visit_range" skips the rest.
+    template < typename Union, typename T, typename Func, typename Reduce >
+    struct visit_folder
+    {
+        T *       accumulator;
+        Func *    visitor;
+        Reduce *  reducer;
+
+        template < typename U >
+        void  fold( U &&member ) const
+        {
+            *accumulator = ( *reducer )( std::move(*accumulator),
+             (*visitor)(std::forward<U>( member )) );
+        }
+
+        template < typename U >
+        auto  operator ()( U &&member ) const -> typename std::enable_if<
+         !is_self_pointer<Union, typename std::decay<U>::type>::value>::type
+        { this->fold( std::forward<U>(member) ); }
+
+        template < typename U >
+        auto  operator ()( U &&member ) const -> typename std::enable_if<
+         is_self_pointer<Union, typename std::decay<U>::type>::value,
+         decltype( (void)(*visitor)(std::forward<U>( member )) )>::type
+        { this->fold( std::forward<U>(member) ); }
+    };
+
+    // The number of elements in each chunk: a whole number of the blocks
+    // "visit_range" sorts by type, about as big as a typical L2 cache, or one
+    // block if that's bigger.  The blocks are 2,048 elements, so chunks of an
+    // aligned array never share a cache line.
+    constexpr
+    auto  visit_chunk_size( std::size_t elements_in_cache ) noexcept
+      -> std::size_t
+    {
+        return elements_in_cache > 2048u ? elements_in_cache / 2048u * 2048u :
+         2048u;
+    }
+
+    template < typename Iterator >
+    constexpr
+    auto  visit_chunk_size() noexcept -> std::size_t
+    {
+        return visit_chunk_size( (std::size_t{ 256u } << 10) / sizeof(typename
+         std::iterator_traits<Iterator>::value_type) );
+    }
+
+    // A thread's accumulator once handed over, on cache lines of its own so
+    // the hand-overs don't contend (and so "bool" isn't packed into bits)
+    template < typename T >
+    struct alignas( BOOST_UNIONS_CACHE_LINE_SIZE ) alignas( T )
+      visit_accumulator
+    {
+        T  value;
+    };
+
+    // One thread's share: claim chunks until none are left, then hand over
+    // the accumulator
+    template < typename Iterator, typename T, typename Func, typename Reduce >
+    struct visit_reduce_job
+    {
+        Iterator                    first;
+        std::size_t                 size;
+        std::atomic<std::size_t> *  next;
+        T *                         result;
+        Func                        visitor;
+        Reduce                      reducer;
+        std::exception_ptr *        error;
+        std::mutex *                error_lock;
+
+        void  operator ()()
+        {
+            try
+            {
+                std::size_t const  chunk = visit_chunk_size<Iterator>();
+                T                  accumulator = *result;
+
+                for ( std::size_t  start = next->fetch_add(chunk,
+                 std::memory_order_relaxed) ; start < size ; start =
+                 next->fetch_add(chunk, std::memory_order_relaxed) )
+                {
+                    Iterator const  b = first + start;
+
+                    unions::visit_range( b, b + (size - start < chunk ? size -
+                     start : chunk), visit_folder<typename union_of<typename
+                     std::iterator_traits<Iterator>::reference>::type, T, Func,
+                     Reduce>{&accumulator, &visitor, &reducer} );
+                }
+                *result = std::move( accumulator );
+            }
+            catch ( ... )
+            {
+                // Stop the others at their next chunk, and keep the first
+                // exception for the caller
+                next->store( size, std::memory_order_relaxed );
+
+                std::lock_guard<std::mutex>  lock{ *error_lock };
+
+                if ( !*error )
+                    *error = std::current_exception();
+            }
+        }
+    };
+}
+//! \endcond
+
+
+//  Parallel visitation function template definition  ------------------------//
+
+//! Fold a visitor over a range of `tagged_union` objects, on several threads
+/** The range is cut into chunks of a whole number of `visit_range` blocks,
+    about 256 KiB each, which the threads claim one at a time from a shared
+    count, so threads that get ahead take more.  Each thread has its own copy
+    of `visitor` and `reducer`, and its own accumulator, starting as a copy of
+    `init`; each member visited (by `visit_range`) updates it as
+    `accumulator = reducer(std::move(accumulator), visitor(member))`.  Once
+    the range is done, the threads' accumulators are merged by `reducer`, in
+    the order of the threads.  Nothing is shared but the chunk count, and
+    accumulators live on their threads' stacks until they are handed back at
+    the end, so threads don't write to each other's cache lines.
+
+    The calling thread is one of the `threads`; the others are started for
+    the call.  A range of one chunk or less is visited on the calling thread
+    alone.
+
+    Since the chunks go to threads in no set order, and `visit_range` visits
+    the members of a block by type, `reducer` should be associative and
+    commutative, and `init` its identity (e.g. 0 for a sum), for the result
+    not to depend on the threads' timing.  As with `visit_range`, empty
+    elements are skipped, as are pointers-to-self that `visitor` can't take.
+
+    \pre  `[first, last)` is a valid range of `tagged_union` objects.
+    \pre  `visitor` can be called with every variant member (ignoring
+          pointers-to-self); this is checked at compile-time.
+
+    \param first    The start of the range.
+    \param last     The end of the range.
+    \param init     The starting value of each accumulator.
+    \param visitor  The function object called with each member.  Copied for
+                    each thread.
+    \param reducer  The function object folding a visit's result into an
+                    accumulator, and merging accumulators.  Copied for each
+                    thread.
+    \param threads  The number of threads to use; zero for as many as the
+                    hardware runs at once.
+
+    \throws  Whatever `visitor` or `reducer` throws, the first exception on
+             any thread; the other threads stop at their next chunk.  Also
+             `std::system_error` if a thread can't be started.
+
+    \returns  The merged accumulators.
+
+    \see  visit_range
+ */
+template < typename RandomAccessIterator, typename T, typename Func, typename
+ Reduce >
+T  parallel_visit_reduce( RandomAccessIterator first, RandomAccessIterator
+ last, T init, Func visitor, Reduce reducer, std::size_t threads = 0u )
+{
+    typedef detail::visit_reduce_job<RandomAccessIterator, T, Func, Reduce>
+      job_type;
+    typedef detail::visit_accumulator<T>  result_type;
+
+    std::size_t const  size = last - first;
+    std::size_t const  chunks = ( size + detail::visit_chunk_size<
+     RandomAccessIterator>() - 1u ) / detail::visit_chunk_size<
+     RandomAccessIterator>();
+
+    if ( !threads )
+        threads = std::thread::hardware_concurrency();
+    if ( threads > chunks )
+        threads = chunks;
+    if ( threads < 2u )
+    {
+        unions::visit_range( first, last, detail::visit_folder<typename
+         detail::union_of<typename std::iterator_traits<RandomAccessIterator>
+         ::reference>::type, T, Func, Reduce>{&init, &visitor, &reducer} );
+        return init;
+    }
+
+    std::atomic<std::size_t>  next{ 0u };
+    std::vector<result_type>  results( threads, result_type{init} );
+    std::exception_ptr        error;
+    std::mutex                error_lock;
+    std::vector<std::thread>  helpers;
+
+    helpers.reserve( threads - 1u );
+    try
+    {
+        for ( std::size_t  i = 1u ; i < threads ; ++i )
+            helpers.emplace_back( job_type{first, size, &next,
+             &results[i].value, visitor, reducer, &error, &error_lock} );
+    }
+    catch ( ... )
+    {
+        // Stop the helpers already started, at their next chunk
+        next.store( size, std::memory_order_relaxed );
+        for ( std::thread &t : helpers )
+            t.join();
+        throw;
+    }
+    job_type{ first, size, &next, &results[0].value, visitor, reducer,
+     &error, &error_lock }();
+    for ( std::thread &t : helpers )
+        t.join();
+    if ( error )
+        std::rethrow_exception( error );
+
+    T  result = std::move( results[0].value );
+
+    for ( std::size_t  i = 1u ; i < threads ; ++i )
+        result = reducer( std::move(result), std::move(results[ i ].value) );
+    return result;
+}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_PARALLEL_VISIT_HPP
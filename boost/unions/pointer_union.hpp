@@ -0,0 +1,392 @@
+//  Boost Unions Library, pointer_union.hpp header file  ---------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A tagged-union of pointers, packed into a single pointer-sized word.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions of `pointer_union`, a counterpart
+    of `tagged_union` for when every variant type is an object pointer.  The
+    index of the active variant is kept in the low-order bits that the pointed-
+    to types' alignment leaves zero, so the whole union is one `std::uintptr_t`.
+    Also defines `pointee_alignment`, a traits class that can be specialized to
+    promise more alignment than `alignof` gives (or any at all, for incomplete
+    types), and the usual access functions and traits specializations.
+ */
+
+#ifndef BOOST_UNIONS_POINTER_UNION_HPP
+#define BOOST_UNIONS_POINTER_UNION_HPP
+
+#include "boost/mpl/contains_v.hpp"
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/mpl/type_at_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/variant_traits.hpp"
+#include <boost/assert.hpp>
+#include <boost/variant/get.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <typeinfo>
+#include <type_traits>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Pointee alignment traits class template definition  ----------------------//
+
+//! Meta-function: pointed-to type -> alignment guaranteed for its addresses
+/** `pointer_union` takes its tag bits from this.  The default is `alignof(T)`.
+    Specialize it for types that are always allocated more strictly than that
+    (to get more tag bits), or for types that are incomplete where the
+    `pointer_union` is declared.  The value must be a power of two.
+
+    \tparam T  The pointed-to type, without cv-qualification.
+ */
+template < typename T >
+struct pointee_alignment
+    : std::integral_constant<std::size_t, alignof(T)>
+{ };
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    constexpr
+    auto  alignment_bits( std::size_t alignment ) noexcept -> std::size_t
+    { return ( alignment > 1u ) ? 1u + alignment_bits( alignment / 2u ) : 0u; }
+
+    constexpr
+    auto  min_of( std::size_t only ) noexcept -> std::size_t
+    { return only; }
+
+    template < typename ...T >
+    constexpr
+    auto  min_of( std::size_t first, std::size_t second, T ...rest ) noexcept
+      -> std::size_t
+    { return min_of( first < second ? first : second, rest... ); }
+
+    template < typename T >
+    struct pointer_tag_bits
+        : std::integral_constant<std::size_t, alignment_bits(pointee_alignment<
+           typename std::remove_cv<typename std::remove_pointer<T>::type>::type
+           >::value)>
+    { };
+}
+//! \endcond
+
+
+//  Pointer-packed tagged union class template definition  ------------------//
+
+//! Union-type of pointers with the tag in their spare low-order bits
+/** Works like `tagged_union` when all of `Types` are object pointers, but the
+    whole union is a single `std::uintptr_t`.  Addresses of the pointed-to
+    types are multiples of their alignment, so their lowest bits are always
+    zero; the index of the active variant is stored there instead.  Reading a
+    pointer back out masks those bits off, and needs no jump.
+
+    Like `tagged_union`, pointers to (possibly cv-qualified) `pointer_union`
+    are implicit variant types, just after `Types`, and there is an empty
+    state.  So every index from zero to `#empty_index()` has to fit in the
+    bits that the least aligned pointee leaves free; on a typical 64-bit
+    system, that allows three types pointing to 8-byte aligned objects.  Use
+    `pointee_alignment` to promise more alignment when the objects come from
+    an allocator that gives it.  Storing a pointer whose tag bits aren't zero
+    (say, a `char *` into the middle of a buffer, cast to a listed type) is
+    an error, caught by `BOOST_ASSERT`.
+
+    Objects are trivially copyable, and copying one is a single register move.
+    The access functions return the stored pointers by value, as there is no
+    pointer object to refer to.
+
+    \tparam Types  The pointer types to be included in the union.  It may be
+                   empty.  Each must be a pointer to a (possibly cv-qualified)
+                   object type.  Repeats are not flagged.
+ */
+template < typename ...Types >
+class pointer_union
+{
+    static_assert( detail::all_of<(std::is_pointer<Types>::value &&
+     std::is_object<typename std::remove_pointer<Types>::type>::value)...>
+     ::value, "Each variant type must be a pointer to an object type" );
+
+public:
+    //! The type of the packed pointer-and-tag representation
+    typedef std::uintptr_t  word_type;
+
+    //! The number of low-order bits available for the tag
+    static constexpr  std::size_t  tag_bits = detail::min_of(
+     detail::alignment_bits(alignof( word_type )),
+     detail::pointer_tag_bits<Types>::value... );
+    //! The mask for the tag bits within `word()`
+    static constexpr  word_type  tag_mask = ( word_type(1u) << tag_bits ) - 1u;
+
+    static_assert( sizeof...(Types) + 4u <= tag_mask, "The pointed-to types "
+     "aren't aligned enough to leave room for the tag" );
+
+    //! Returns a list of the union's variant members' types.
+    static
+    auto  variant_types() noexcept
+      -> std::array<std::type_info const *, sizeof...(Types)>
+    { return { {&typeid(Types)...} }; }
+
+    //! Returns the index used by `stored_index` when no pointer is stored.
+    static constexpr
+    auto  empty_index() noexcept -> std::size_t
+    { return sizeof...(Types) + 4u; }
+    //! Returns the index `stored_index` uses for type `T`.
+    /** \returns  The index of `T` within `Types` if it's there, else
+                  `variant_size + 0` through `+ 3` for `pointer_union *`,
+                  `pointer_union const *`, `pointer_union volatile *`, and
+                  `pointer_union const volatile *`, respectively; otherwise
+                  `#empty_index()`.
+     */
+    template < typename T >
+    static constexpr
+    auto  index_of() noexcept -> std::size_t
+    {
+        return mpl::index_of_v<T, Types..., pointer_union *,
+         pointer_union const *, pointer_union volatile *,
+         pointer_union const volatile *>::value;
+    }
+
+    //! Default-construction, with no data
+    constexpr  pointer_union() noexcept
+        : word_{ empty_index() }
+    { }
+
+    //! Construction from a variant type
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            mpl::contains_v<T, Types...>::value
+        >::type
+    >
+    pointer_union( T that ) noexcept
+        : word_{ pack(that) }
+    { }
+    //! Construction by copying a pointer to self
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<pointer_union, T>::value
+        >::type
+    >
+    pointer_union( T const volatile *that ) noexcept
+        : word_{ pack(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<pointer_union, T>::value
+        >::type
+    >
+    pointer_union( T volatile *that ) noexcept
+        : word_{ pack(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<pointer_union, T>::value
+        >::type
+    >
+    pointer_union( T const *that ) noexcept
+        : word_{ pack(that) }
+    { }
+    //! \overload
+    template <
+        typename T,
+        class EnableIf = typename std::enable_if<
+            std::is_same<pointer_union, T>::value
+        >::type
+    >
+    pointer_union( T *that ) noexcept
+        : word_{ pack(that) }
+    { }
+
+    //! Returns the packed representation, with the index in the low bits.
+    auto  word() const noexcept -> word_type
+    { return word_; }
+
+    //! Return the stored address, type-less, and NULL if none.
+    auto  data() const noexcept -> void const volatile *
+    { return reinterpret_cast<void const volatile *>( word_ & ~tag_mask ); }
+
+    //! Check the type of the pointer being stored, NULL if none
+    auto  stored_type() const noexcept -> std::type_info const *
+    {
+        static std::type_info const * const  types[] = {
+            &typeid(Types)..., &typeid(pointer_union *),
+            &typeid(pointer_union const *), &typeid(pointer_union volatile *),
+            &typeid(pointer_union const volatile *), nullptr
+        };
+
+        return types[ stored_index() ];
+    }
+    //! Check the index of the pointer being stored, `empty_index()` if none
+    auto  stored_index() const noexcept -> std::size_t
+    { return word_ & tag_mask; }
+    //! Check if current pointer is a pointer-to-self type
+    bool  storing_pointer_to_self() const noexcept
+    {
+        return ( stored_index() >= sizeof...(Types) ) && ( stored_index() !=
+         empty_index() );
+    }
+
+protected:
+    //! Check for self-consistency
+    bool  invariant() const
+    {
+        // The address bits can't be checked, but the index can.
+        return stored_index() <= empty_index();
+    }
+
+private:
+    template < typename T >
+    static
+    auto  pack( T that ) noexcept -> word_type
+    {
+        BOOST_ASSERT( !(reinterpret_cast<word_type>( that ) & tag_mask) );
+        return reinterpret_cast<word_type>( that ) | index_of<typename
+         std::remove_cv<T>::type>();
+    }
+
+    word_type  word_;
+};
+
+//! \cond
+template < typename ...Types >
+constexpr  std::size_t  pointer_union<Types...>::tag_bits;
+template < typename ...Types >
+constexpr  typename pointer_union<Types...>::word_type
+  pointer_union<Types...>::tag_mask;
+//! \endcond
+
+
+//  Pointer-packed union metadata template specialization definitions  -------//
+
+//! Specialization of `variant_element` for `pointer_union`s.
+template < std::size_t Index, typename ...Types >
+struct variant_element<Index, pointer_union<Types...>>
+{
+    typedef typename mpl::type_at_v<Index, Types...>::type  type;
+};  // Note that any repeats are included!
+
+//! Specialization of `variant_size` for `pointer_union`s.
+template < typename ...Types >
+struct variant_size<pointer_union<Types...>>
+    : std::integral_constant<std::size_t, sizeof...(Types)>
+{ };  // Note that all repeats are included!
+
+
+//  Pointer-packed union template data extraction functions  -----------------//
+
+//! Extract the pointer of the given type from the given `pointer_union`.
+/** Besides the types explicitly given in `Types`, a type that is a pointer to
+    cv-qualified `pointer_union` may be used for `T`.  Unlike the `tagged_union`
+    versions, the stored pointer is returned by value.  When the index matches,
+    exclusive-or with it clears the tag bits; otherwise, the word is masked to
+    zero, so the check takes no branch.
+
+    \tparam T      The type of the desired pointer.  Must be explicitly
+                   provided.
+    \tparam Types  The variant types listed in `pu`'s type.  Should not be
+                   explicitly provided.  This variadic list may be empty.
+
+    \param[in] pu  The `pointer_union` object to be accessed.
+
+    \throws  Nothing for the pointer version.  If the wrong type is requested
+             in the reference version, `boost::bad_get` is thrown.
+
+    \returns  `NULL` if `pu` is `NULL` or if the stored variant isn't of type
+              `T`.  The stored pointer otherwise.  (For the reference version,
+              the stored pointer is returned when the type request is right,
+              even if that pointer is `NULL`.)
+ */
+template < typename T, typename ...Types >
+auto  gett( pointer_union<Types...> const *pu ) noexcept -> T
+{
+    typedef pointer_union<Types...>       union_type;
+    typedef typename union_type::word_type  word_type;
+
+    static_assert( union_type::template index_of<T>() !=
+     union_type::empty_index(), "The requested type isn't in the union" );
+
+    word_type const  word = pu ? pu->word() : 0u;
+
+    return reinterpret_cast<T>( (word ^ union_type::template index_of<T>()) &
+     -word_type((word & union_type::tag_mask) ==
+     union_type::template index_of<T>()) );
+}
+
+//! \overload
+template < typename T, typename ...Types >
+auto  gett( pointer_union<Types...> const &pu ) -> T
+{
+    if ( pu.stored_index() != pointer_union<Types...>::template index_of<T>() )
+        throw bad_get{};
+    return gett<T>( &pu );
+}
+
+//! Extract the pointer of the given index from the given `pointer_union`.
+/** This accessor cannot be used to get the secret variants of type
+    `pointer_union\<Types...\> CV *`.
+
+    \pre  `0 \<= Index \< #variant_size\<decltype(pu)\>\::value`
+
+    \tparam Index  The index of the desired variant member.  Must be explicitly
+                   provided.
+    \tparam Types  The variant types listed in `pu`'s type.  Should not be
+                   explicitly provided.  This variadic list may be empty.
+
+    \param[in] pu  The `pointer_union` object to be accessed.
+
+    \throws  Nothing for the pointer version.  If the wrong type is requested
+             in the reference version, `boost::bad_get` is thrown.
+
+    \returns  `NULL` if `pu` is `NULL` or if the stored variant isn't of the
+              requested type.  The stored pointer otherwise.
+ */
+template < std::size_t Index, typename ...Types >
+auto  get( pointer_union<Types...> const *pu ) noexcept
+ -> typename variant_element<Index, pointer_union<Types...>>::type
+{
+    return gett<typename variant_element<Index, pointer_union<Types...>>::type>(
+     pu );
+}
+
+//! \overload
+template < std::size_t Index, typename ...Types >
+auto  get( pointer_union<Types...> const &pu )
+ -> typename variant_element<Index, pointer_union<Types...>>::type
+{
+    return gett<typename variant_element<Index, pointer_union<Types...>>::type>(
+     pu );
+}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_POINTER_UNION_HPP
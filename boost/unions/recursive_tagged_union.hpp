@@ -0,0 +1,331 @@
+//  Boost Unions Library, recursive_tagged_union.hpp header file  ------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Support for trees of tagged-union nodes: an arena and a traversal.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions of `tagged_union_arena`, a bump
+    allocator that owns nodes that are (or derive from) `basic_tagged_union`
+    and frees them all at once, and of `depth_first`, which walks a tree of
+    such nodes without recursion.
+
+    A node links to its children either by storing a pointer to its own union
+    type (which `tagged_union` allows without naming it in `Types`), or
+    through members of its variant types that point to a node class declared
+    ahead of them:
+
+    \code
+    struct expr;
+    struct binary  { char  op; expr const *lhs, *rhs; };
+    struct expr : boost::unions::tagged_union<double, binary>
+    { using basic_tagged_union::basic_tagged_union; };
+    \endcode
+ */
+
+#ifndef BOOST_UNIONS_RECURSIVE_TAGGED_UNION_HPP
+#define BOOST_UNIONS_RECURSIVE_TAGGED_UNION_HPP
+
+#include "boost/unions/tagged_union.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // The basic_tagged_union a node type is, or derives from
+    template < class Policy, typename ...Types >
+    auto  union_base_of( basic_tagged_union<Policy, Types...> const * )
+      -> basic_tagged_union<Policy, Types...>;
+
+    template < class Node >
+    using node_union = decltype( union_base_of(std::declval<Node *>()) );
+
+    // Adds a node's children to the traversal's stack; null links are skipped
+    template < class Node >
+    struct child_pusher
+    {
+        std::vector<Node *> &  stack;
+
+        void  operator ()( Node *child ) const
+        {
+            if ( child )
+                stack.push_back( child );
+        }
+    };
+
+    // Overload ranks, the highest tried first
+    template < unsigned Rank >
+    struct rank : rank<Rank - 1u>  {};
+    template < >
+    struct rank<0u>  {};
+
+    // Finds the children in a node's member: what the user's function pushes,
+    // if it takes the member; else the member itself, if it's a pointer to a
+    // node (which includes pointers-to-self, when the node is its union type)
+    template < class Node, typename Children >
+    struct child_finder
+    {
+        Children &                 children;
+        child_pusher<Node> const  &push;
+
+        template < typename T >
+        void  operator ()( T &&member ) const
+        { this->find( std::forward<T>(member), rank<2u>{} ); }
+
+    private:
+        template < typename T >
+        auto  find( T &&member, rank<2u> ) const
+          -> decltype( void(std::declval<Children &>()( std::forward<T>(member),
+           std::declval<child_pusher<Node> const &>() )) )
+        { children( std::forward<T>(member), push ); }
+        template < typename T >
+        auto  find( T *child, rank<1u> ) const
+          -> decltype( std::declval<child_pusher<Node> const &>()(child) )
+        { push( child ); }
+        template < typename T >
+        void  find( T &&, rank<0u> ) const
+        { }
+    };
+
+    // Takes nothing, so only pointers to nodes are followed
+    struct no_children
+    { };
+}
+//! \endcond
+
+
+//  Tagged union arena class template definition  ----------------------------//
+
+//! Bump allocator for the nodes of tagged-union trees
+/** Each `make` takes the next slot of the current block, so allocating is a
+    bump of a count.  Nodes aren't freed one at a time; `clear` ends all of
+    them at once (just resetting the count when `Node` is trivially
+    destructible), and keeps the blocks for the next tree.  The blocks double
+    in size as they're needed, up to a limit, and are only given back when the
+    arena is destroyed.
+
+    A node's address never changes, so nodes can link to each other with plain
+    pointers, including a `tagged_union`'s pointers-to-self.  The arena can't
+    be copied or moved, since its nodes would be left behind.
+
+    \tparam Node  The type of the nodes; a `basic_tagged_union` type, or a
+                  class derived from one.
+ */
+template < class Node >
+class tagged_union_arena
+{
+    typedef typename std::aligned_storage<sizeof( Node ), alignof( Node )>::type
+      slot_type;
+
+    struct block
+    {
+        std::unique_ptr<slot_type[]>  slots;
+        std::size_t                   size;
+    };
+
+public:
+    //! The type of the nodes
+    typedef Node  value_type;
+    //! The type for counts of nodes
+    typedef std::size_t  size_type;
+
+    //! The number of nodes in the first block
+    static constexpr  size_type  first_block = 64u;
+    //! The most nodes a block can have
+    static constexpr  size_type  largest_block = 65536u;
+
+    //! Construct with no nodes, and no blocks until the first node is made
+    tagged_union_arena() noexcept = default;
+    tagged_union_arena( tagged_union_arena const & ) = delete;
+    //! Destroy all of the nodes, then give back the blocks
+    ~tagged_union_arena()  { this->clear(); }
+
+    tagged_union_arena &  operator =( tagged_union_arena const & ) = delete;
+
+    //! Build a node from `args` in the next slot
+    /** \throws  Whatever the node's constructor throws, or `std::bad_alloc`
+                 if a new block is needed and can't be had.  The arena is
+                 unchanged then.
+
+        \returns  A pointer to the new node, valid until `clear`.
+     */
+    template < typename ...Args >
+    auto  make( Args&& ...args ) -> Node *
+    {
+        if ( blocks_.empty() || used_ == blocks_[current_].size )
+            this->next_block();
+
+        Node * const  result = ::new ( &blocks_[current_].slots[used_] ) Node(
+         std::forward<Args>(args)... );
+
+        ++used_;
+        ++count_;
+        return result;
+    }
+
+    //! Destroy all of the nodes at once, keeping the blocks for reuse
+    /** Every pointer from `make` is invalid afterwards.
+     */
+    void  clear() noexcept
+    {
+        this->destroy_nodes( std::is_trivially_destructible<Node>{} );
+        current_ = used_ = count_ = 0u;
+    }
+
+    //! The number of nodes made since the last `clear`
+    auto  size() const noexcept -> size_type  { return count_; }
+    //! The number of nodes the blocks had room for
+    auto  capacity() const noexcept -> size_type
+    {
+        size_type  result = 0u;
+
+        for ( block const &b : blocks_ )
+            result += b.size;
+        return result;
+    }
+
+private:
+    // Move on to the next block, reusing one kept by "clear" if there is one
+    void  next_block()
+    {
+        if ( current_ + 1u < blocks_.size() )
+        {
+            ++current_;
+            used_ = 0u;
+            return;
+        }
+
+        size_type const  size = blocks_.empty() ? first_block : std::min<
+         size_type>( 2u * blocks_.back().size, largest_block );
+
+        blocks_.reserve( blocks_.size() + 1u );
+        blocks_.push_back( block{std::unique_ptr<slot_type[]>( new
+         slot_type[size] ), size} );
+        current_ = blocks_.size() - 1u;
+        used_ = 0u;
+    }
+
+    void  destroy_nodes( std::true_type ) noexcept
+    { }
+    void  destroy_nodes( std::false_type ) noexcept
+    {
+        for ( size_type  b = 0u ; b < blocks_.size() && b <= current_ ; ++b )
+        {
+            slot_type * const  slots = blocks_[ b ].slots.get();
+            size_type const    n = ( b < current_ ) ? blocks_[ b ].size : used_;
+
+            for ( size_type  i = 0u ; i < n ; ++i )
+                reinterpret_cast<Node *>( slots + i )->~Node();
+        }
+    }
+
+    // Member data
+    std::vector<block>  blocks_;
+    size_type           current_ = 0u;  // the block being filled
+    size_type           used_ = 0u;     // slots taken in the current block
+    size_type           count_ = 0u;    // nodes made since "clear"
+};
+
+//! \cond
+template < class Node >
+constexpr typename tagged_union_arena<Node>::size_type
+  tagged_union_arena<Node>::first_block;
+template < class Node >
+constexpr typename tagged_union_arena<Node>::size_type
+  tagged_union_arena<Node>::largest_block;
+//! \endcond
+
+
+//  Tagged union tree traversal function definitions  ------------------------//
+
+//! Visit a tree of tagged-union nodes depth-first, without recursion
+/** Each node is passed to `visitor` before its children (pre-order), and the
+    children are taken in the order given.  The pending nodes are kept on a
+    stack in a `std::vector`, so deep trees can't overflow the call stack.
+
+    The children of a node are found by `visit`ing its variant member (or
+    stored pointer-to-self), `member`.  If `children(member, push)` is valid,
+    it's called, and the nodes it passes to `push` (a function object taking
+    `Node *`) are the children.  Otherwise, if `member` is a pointer that
+    converts to `Node *`, it's the one child; that covers pointers-to-self,
+    when `Node` is its own `tagged_union` type.  Null pointers are skipped.
+
+    Empty nodes have no children.
+
+    \param root      The node to start from.
+    \param visitor   The function object called with each node, as `Node &`.
+    \param children  The function object that finds the children in a member.
+
+    \throws  Whatever `visitor` or `children` throws, or `std::bad_alloc`.
+ */
+template < class Node, typename Visitor, typename Children >
+void  depth_first( Node &root, Visitor &&visitor, Children &&children )
+{
+    typedef detail::node_union<Node>  union_type;
+    typedef typename std::conditional<std::is_const<Node>::value, union_type
+     const &, union_type &>::type  union_reference;
+
+    std::vector<Node *>               stack{ &root };
+    detail::child_pusher<Node> const  push{ stack };
+    detail::child_finder<Node, typename std::remove_reference<Children>::type>
+     const                            find{ children, push };
+
+    while ( !stack.empty() )
+    {
+        Node &             node = *stack.back();
+        std::size_t const  mark = stack.size() - 1u;
+
+        stack.pop_back();
+        visitor( node );
+        if ( node.stored_index() != union_type::empty_index() )
+            unions::visit( find, static_cast<union_reference>(node) );
+
+        // The children were pushed in order, so the first is deepest
+        std::reverse( stack.begin() + mark, stack.end() );
+    }
+}
+
+//! \overload
+/** Only members that are pointers to nodes, including pointers-to-self, are
+    followed.
+ */
+template < class Node, typename Visitor >
+void  depth_first( Node &root, Visitor &&visitor )
+{
+    unions::depth_first( root, std::forward<Visitor>(visitor),
+     detail::no_children{} );
+}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_RECURSIVE_TAGGED_UNION_HPP
@@ -0,0 +1,245 @@
+//  Boost Unions Library, shared_channel.hpp header file  --------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Sharing `tagged_union` objects between processes.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definitions of `is_address_free`, a trait for the
+    `tagged_union` types whose objects mean the same thing at any address and
+    in any process, and of `tagged_union_channel`, a single-producer,
+    single-consumer queue of those unions meant to be placed in shared memory
+    (e.g. from `shm_open` and `mmap`, or a file mapped by each process).
+ */
+
+#ifndef BOOST_UNIONS_SHARED_CHANNEL_HPP
+#define BOOST_UNIONS_SHARED_CHANNEL_HPP
+
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/union_policy.hpp"
+#include <boost/variant/get.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Address-free trait class template definition  ----------------------------//
+
+//! Check if a union type's objects can be shared between processes
+/** A `basic_tagged_union` keeps its active type as an index, not an address,
+    so its bytes hold something tied to one process only through a member:
+    one that is or holds a pointer, one boxed on the heap by the policy, or a
+    pointer-to-self.  This trait is true when every variant type is trivially
+    copyable, kept inline, and not a pointer or pointer-to-member.  Objects of
+    such a type can be placed in shared memory, or copied as bytes to another
+    process, and read there with no translation; pointers-to-self have to be
+    kept out, which is checked at run time.
+
+    A trivially copyable class type can still hold pointers, which the trait
+    can't see; keeping those out of shared objects is the user's
+    responsibility.
+
+    Both sides must of course be built with the same variant types, in the
+    same order, with the same layout.
+
+    \tparam Union  The type to check.  Anything other than a specialization of
+                   `basic_tagged_union` gives false.
+ */
+template < class Union >
+struct is_address_free
+    : std::false_type
+{ };
+
+//! \cond
+template < class Policy, typename ...Types >
+struct is_address_free< basic_tagged_union<Policy, Types...> >
+    : std::integral_constant<bool, detail::all_of<
+       std::is_trivially_copyable<Types>::value...,
+       !detail::boxes<Policy, Types>::value...,
+       !std::is_pointer<Types>::value...,
+       !std::is_member_pointer<Types>::value...>::value>
+{ };
+//! \endcond
+
+
+//  Shared channel class template definition  --------------------------------//
+
+//! Single-producer, single-consumer queue of unions, for shared memory
+/** A ring of `Capacity` union slots and two counters, all inside the object,
+    so the object can be placed in memory shared by two processes (mapped at
+    different addresses or not) and used from both.  One process (or thread)
+    pushes and the other pops; neither ever blocks.  The counters are
+    lock-free atomics, which are also address-free on the platforms this
+    supports, and each sits on its own cache line next to the copy of the
+    other side's counter its owner last saw, so a side touches the other's
+    line only when the ring looks full (or empty) to it.
+
+    Create the channel with placement-new in the shared memory, once, before
+    the other side looks at it; the other side just casts the address.  The
+    memory should be aligned to `BOOST_UNIONS_CACHE_LINE_SIZE`, which `mmap`
+    always gives.
+
+    \code
+    typedef boost::unions::tagged_union<int, double>            message;
+    typedef boost::unions::tagged_union_channel<message, 1024>  channel;
+
+    void *  p = mmap( nullptr, sizeof(channel), PROT_READ | PROT_WRITE,
+     MAP_SHARED, fd, 0 );
+    channel *  c = ::new ( p ) channel;  // or static_cast, by the other side
+    \endcode
+
+    \tparam Union     The type of the values passed.  Must satisfy
+                      `is_address_free`.
+    \tparam Capacity  The number of slots.  Must be a power of two, from 1 to
+                      2<sup>31</sup>.
+ */
+template < class Union, std::size_t Capacity >
+class tagged_union_channel
+{
+    static_assert( is_address_free<Union>::value, "The union type must be "
+     "address-free to be shared" );
+    static_assert( Capacity && !(Capacity & (Capacity - 1u)) && Capacity <=
+     (std::size_t{ 1u } << 31), "The capacity must be a power of two" );
+    static_assert( ATOMIC_INT_LOCK_FREE == 2, "The counters must be lock-free "
+     "to be shared" );
+
+    // The counters run freely, wrapping around; a slot is "count % Capacity"
+    typedef std::uint_least32_t  count_type;
+
+public:
+    //! The type of the values passed
+    typedef Union  value_type;
+
+    //! The number of values the channel holds at most
+    static constexpr
+    auto  capacity() noexcept -> std::size_t  { return Capacity; }
+
+    //! Start empty
+    tagged_union_channel() noexcept
+        : tail_{ 0u }, head_seen_{ 0u }, head_{ 0u }, tail_seen_{ 0u }
+    { }
+    //! Can't be copied, since it's shared in place
+    tagged_union_channel( tagged_union_channel const & ) = delete;
+    //! Can't be copied, since it's shared in place
+    auto  operator =( tagged_union_channel const & ) -> tagged_union_channel &
+      = delete;
+
+    //! Add a copy of `value` at the back, unless the channel is full
+    /** Call from the producing side only.
+
+        \throws  boost::bad_get  if `value` stores a pointer-to-self, which
+                 has no meaning in the other process.
+
+        \retval true   `value` was added.
+        \retval false  The channel is full; nothing was done.
+     */
+    bool  try_push( value_type const &value )
+    {
+        if ( value.storing_pointer_to_self() )
+            throw bad_get{};
+
+        count_type const  tail = tail_.load( std::memory_order_relaxed );
+
+        if ( static_cast<count_type>(tail - head_seen_) == Capacity )
+        {
+            head_seen_ = head_.load( std::memory_order_acquire );
+            if ( static_cast<count_type>(tail - head_seen_) == Capacity )
+                return false;
+        }
+        slots_[ tail % Capacity ] = value;
+        tail_.store( static_cast<count_type>(tail + 1u),
+         std::memory_order_release );
+        return true;
+    }
+
+    //! Access the value at the front, in place, if any
+    /** Call from the consuming side only.  The value stays put until `pop`.
+
+        \returns  The address of the oldest value not yet popped, or NULL if
+                  the channel is empty.
+     */
+    auto  front() noexcept -> value_type const *
+    {
+        count_type const  head = head_.load( std::memory_order_relaxed );
+
+        if ( head == tail_seen_ )
+        {
+            tail_seen_ = tail_.load( std::memory_order_acquire );
+            if ( head == tail_seen_ )
+                return nullptr;
+        }
+        return slots_ + head % Capacity;
+    }
+    //! Drop the value at the front, handing its slot back to the producer
+    /** Call from the consuming side only, after `front` gave a value.
+     */
+    void  pop() noexcept
+    {
+        head_.store( static_cast<count_type>(head_.load(
+         std::memory_order_relaxed ) + 1u), std::memory_order_release );
+    }
+    //! Copy the value at the front to `value`, unless the channel is empty
+    /** Call from the consuming side only.
+
+        \retval true   The oldest value was copied to `value` and dropped.
+        \retval false  The channel is empty; nothing was done.
+     */
+    bool  try_pop( value_type &value ) noexcept
+    {
+        if ( value_type const * const  f = this->front() )
+        {
+            value = *f;
+            this->pop();
+            return true;
+        }
+        return false;
+    }
+
+    //! The number of values waiting, as of some moment during the call
+    auto  size() const noexcept -> std::size_t
+    {
+        count_type const  head = head_.load( std::memory_order_acquire );
+
+        return static_cast<count_type>( tail_.load(std::memory_order_acquire)
+         - head );
+    }
+    //! Check if no values are waiting, as of some moment during the call
+    bool  empty() const noexcept  { return !this->size(); }
+
+private:
+    // Member data; the producer writes the first line, the consumer the second
+    alignas( BOOST_UNIONS_CACHE_LINE_SIZE )
+    std::atomic<count_type>  tail_;       // the count pushed
+    count_type               head_seen_;  // "head_" as last read by producer
+    alignas( BOOST_UNIONS_CACHE_LINE_SIZE )
+    std::atomic<count_type>  head_;       // the count popped
+    count_type               tail_seen_;  // "tail_" as last read by consumer
+    alignas( BOOST_UNIONS_CACHE_LINE_SIZE )
+    value_type               slots_[ Capacity ];
+};
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_SHARED_CHANNEL_HPP
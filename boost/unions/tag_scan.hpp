@@ -0,0 +1,436 @@
+//  Boost Unions Library, tag_scan.hpp header file  --------------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Algorithms to count, find, and filter elements by stored type.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definitions of `count_tag`, `find_tag`, and `mask_tag`, which
+    scan a dense array of tags, and of `count_alternative`, `find_alternative`,
+    and `mask_alternative`, which ask the same questions by type of a
+    `tagged_union_soa` or of a range of `tagged_union` objects.  Byte-sized
+    tags (which is what a `tagged_union_soa` of fewer than 256 types uses) are
+    compared 64 at a time with SSE2 or AVX2 when the target has them.  It also
+    defines the `BOOST_UNIONS_NO_SIMD` configuration macro.
+ */
+
+#ifndef BOOST_UNIONS_TAG_SCAN_HPP
+#define BOOST_UNIONS_TAG_SCAN_HPP
+
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/tagged_union_soa.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+
+//  Configuration macros  ----------------------------------------------------//
+
+/** \def  BOOST_UNIONS_NO_SIMD
+    \brief  Define this to make the tag scans use only portable code.
+
+    Otherwise, byte-sized tags are compared with AVX2 when the compiler targets
+    it (e.g. GCC's `-mavx2` or `-march=native`), else with SSE2 on x86 targets
+    that have it (all x86-64 ones), else with portable code.
+ */
+//! \cond
+#if !defined( BOOST_UNIONS_NO_SIMD ) && defined( __AVX2__ )
+#define BOOST_UNIONS_DETAIL_TAG_SCAN_AVX2
+#include <immintrin.h>
+#elif !defined( BOOST_UNIONS_NO_SIMD ) && ( defined(__SSE2__) ||  \
+ defined(_M_X64) || (defined( _M_IX86_FP ) && _M_IX86_FP >= 2) )
+#define BOOST_UNIONS_DETAIL_TAG_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+//! \endcond
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // Tags are compared a block at a time, giving a bit-mask with bit "i" set
+    // when tag "i" of the block matches.
+    static constexpr  std::size_t  tag_block = 64u;
+
+    // (Without a popcount instruction, GCC's built-in is a library call that's
+    // slower than doing it by hand.)
+    inline  auto  count_bits( std::uint64_t x ) noexcept -> std::size_t
+    {
+#if defined( __GNUC__ ) && defined( __POPCNT__ )
+        return __builtin_popcountll( x );
+#else
+        x -= ( x >> 1 ) & 0x5555555555555555u;
+        x = ( x & 0x3333333333333333u ) + ( (x >> 2) & 0x3333333333333333u );
+        x = ( x + (x >> 4) ) & 0x0F0F0F0F0F0F0F0Fu;
+        return ( x * 0x0101010101010101u ) >> 56;
+#endif
+    }
+
+    // "x" must not be zero
+    inline  auto  lowest_bit( std::uint64_t x ) noexcept -> std::size_t
+    {
+#if defined( __GNUC__ )
+        return __builtin_ctzll( x );
+#else
+        std::size_t  result = 0u;
+
+        for ( ; !(x & 1u) ; x >>= 1 )
+            ++result;
+        return result;
+#endif
+    }
+
+    // The first "n" tags, up to a block
+    template < typename Tag >
+    auto  match_tags( Tag const *tags, std::size_t n, Tag tag ) noexcept
+      -> std::uint64_t
+    {
+        std::uint64_t  result = 0u;
+
+        for ( std::size_t  i = 0u ; i < n ; ++i )
+            result |= static_cast<std::uint64_t>( tags[i] == tag ) << i;
+        return result;
+    }
+
+    // A full block
+    template < typename Tag >
+    auto  match_block( Tag const *tags, Tag tag ) noexcept -> std::uint64_t
+    { return match_tags( tags, tag_block, tag ); }
+
+#if defined( BOOST_UNIONS_DETAIL_TAG_SCAN_AVX2 )
+    inline
+    auto  match_block( unsigned char const *tags, unsigned char tag ) noexcept
+      -> std::uint64_t
+    {
+        __m256i const  t = _mm256_set1_epi8( static_cast<char>(tag) );
+        __m256i const  lo = _mm256_loadu_si256( reinterpret_cast<__m256i
+         const *>(tags) );
+        __m256i const  hi = _mm256_loadu_si256( reinterpret_cast<__m256i
+         const *>(tags + 32) );
+
+        return static_cast<std::uint32_t>( _mm256_movemask_epi8(
+         _mm256_cmpeq_epi8(lo, t)) ) | static_cast<std::uint64_t>(
+         static_cast<std::uint32_t>(_mm256_movemask_epi8( _mm256_cmpeq_epi8(hi,
+         t) )) ) << 32;
+    }
+#elif defined( BOOST_UNIONS_DETAIL_TAG_SCAN_SSE2 )
+    inline
+    auto  match_block( unsigned char const *tags, unsigned char tag ) noexcept
+      -> std::uint64_t
+    {
+        __m128i const   t = _mm_set1_epi8( static_cast<char>(tag) );
+        __m128i const * p = reinterpret_cast<__m128i const *>( tags );
+        std::uint32_t   lo = _mm_movemask_epi8( _mm_cmpeq_epi8(_mm_loadu_si128(
+         p), t) ) | _mm_movemask_epi8( _mm_cmpeq_epi8(_mm_loadu_si128( p + 1 ),
+         t) ) << 16;
+        std::uint32_t   hi = _mm_movemask_epi8( _mm_cmpeq_epi8(_mm_loadu_si128(
+         p + 2 ), t) ) | _mm_movemask_epi8( _mm_cmpeq_epi8(_mm_loadu_si128( p +
+         3 ), t) ) << 16;
+
+        return lo | static_cast<std::uint64_t>( hi ) << 32;
+    }
+#endif
+
+    // Count the matches in "blocks" full blocks
+    template < typename Tag >
+    auto  count_blocks( Tag const *tags, std::size_t blocks, Tag tag ) noexcept
+      -> std::size_t
+    {
+        std::size_t  result = 0u;
+
+        for ( ; blocks-- ; tags += tag_block )
+            result += count_bits( match_block(tags, tag) );
+        return result;
+    }
+
+#if defined( BOOST_UNIONS_DETAIL_TAG_SCAN_AVX2 ) || defined(                  \
+ BOOST_UNIONS_DETAIL_TAG_SCAN_SSE2 )
+    // Each byte lane counts its matches, subtracting the all-ones that mark
+    // one, for up to 255 rounds; then the lanes are summed.  This skips the
+    // bit-mask and its population count.
+    inline
+    auto  count_blocks( unsigned char const *tags, std::size_t blocks, unsigned
+     char tag ) noexcept -> std::size_t
+    {
+        __m128i const   t = _mm_set1_epi8( static_cast<char>(tag) );
+        __m128i const * p = reinterpret_cast<__m128i const *>( tags );
+        std::size_t     result = 0u;
+
+        for ( std::size_t  rounds = 4u * blocks ; rounds ; )
+        {
+            std::size_t const  n = rounds < 255u ? rounds : 255u;
+            __m128i            lanes = _mm_setzero_si128();
+
+            for ( std::size_t  i = 0u ; i < n ; ++i )
+                lanes = _mm_sub_epi8( lanes, _mm_cmpeq_epi8(_mm_loadu_si128(
+                 p++ ), t) );
+            lanes = _mm_sad_epu8( lanes, _mm_setzero_si128() );
+            result += static_cast<std::size_t>( _mm_cvtsi128_si32(lanes) ) +
+             static_cast<std::size_t>( _mm_cvtsi128_si32(_mm_srli_si128( lanes,
+             8 )) );
+            rounds -= n;
+        }
+        return result;
+    }
+#endif
+
+    // The tagged_union type of a range's elements
+    template < typename Iterator >
+    using union_range_value = typename std::remove_cv<typename
+     std::iterator_traits<Iterator>::value_type>::type;
+
+    // Whether "T" is one of the variant types of a tagged_union type
+    template < typename T, typename Union >
+    struct is_range_alternative;
+
+    template < typename T, class Policy, typename ...Types >
+    struct is_range_alternative<T, basic_tagged_union<Policy, Types...>>
+        : std::integral_constant<bool, ( mpl::index_of_v<T, Types...>::value <
+           sizeof...(Types) )>
+    { };
+}
+//! \endcond
+
+
+//  Tag array scanning function definitions  ---------------------------------//
+
+//! Count the tags in `[first, last)` equal to `tag`
+/** \returns  The number of matches.
+ */
+template < typename Tag >
+auto  count_tag( Tag const *first, Tag const *last, Tag tag ) noexcept
+  -> std::size_t
+{
+    std::size_t const  blocks = ( last - first ) / detail::tag_block;
+    std::size_t const  result = detail::count_blocks( first, blocks, tag );
+
+    first += blocks * detail::tag_block;
+    return result + detail::count_bits( detail::match_tags(first, last - first,
+     tag) );
+}
+
+//! Find the first tag in `[first, last)` equal to `tag`
+/** \returns  A pointer to the match, or `last` if there isn't one.
+ */
+template < typename Tag >
+auto  find_tag( Tag const *first, Tag const *last, Tag tag ) noexcept
+  -> Tag const *
+{
+    for ( ; static_cast<std::size_t>(last - first) >= detail::tag_block ; first
+     += detail::tag_block )
+        if ( std::uint64_t const  m = detail::match_block(first, tag) )
+            return first + detail::lowest_bit( m );
+
+    std::uint64_t const  m = detail::match_tags( first, last - first, tag );
+
+    return m ? first + detail::lowest_bit( m ) : last;
+}
+
+//! Mark which tags in `[first, last)` equal `tag`
+/** Bit `i % 64` of `bits[i / 64]` is set if `first[i]` matches, and cleared
+    otherwise.  The bits past the end, in the last word, are cleared.
+
+    \pre  `bits` points to at least `(last - first + 63) / 64` words.
+
+    \returns  The number of matches.
+ */
+template < typename Tag >
+auto  mask_tag( Tag const *first, Tag const *last, Tag tag, std::uint64_t
+ *bits ) noexcept -> std::size_t
+{
+    std::size_t  result = 0u;
+
+    for ( ; static_cast<std::size_t>(last - first) >= detail::tag_block ; first
+     += detail::tag_block )
+        result += detail::count_bits( *bits++ = detail::match_block(first, tag)
+         );
+    if ( first != last )
+        result += detail::count_bits( *bits = detail::match_tags(first, last -
+         first, tag) );
+    return result;
+}
+
+
+//  Type-tagged container scanning function definitions  ---------------------//
+
+/** \defgroup  alternative_scans  Scans by stored type
+
+    Each of these asks which elements store a `T` object.  For a
+    `tagged_union_soa`, that's a scan of its dense tag array, using the tag
+    functions above (so SIMD, where it's available).  For a range of
+    `tagged_union`, it's one `stored_index` comparison per element, with no
+    `std::type_info` involved; the tags aren't contiguous there, so no SIMD.
+    The element positions are logical indices, counted from the start of the
+    container or range.  `T` must be one of the variant types; anything else
+    (including a pointer-to-self) fails to compile.
+ */
+//@{
+//! Count the elements holding a `T` (this just calls `s.count<T>()`)
+template < typename T, typename ...Types >
+auto  count_alternative( tagged_union_soa<Types...> const &s ) noexcept
+  -> std::size_t
+{
+    static_assert( mpl::index_of_v<T, Types...>::value < sizeof...(Types),
+     "Not a variant type" );
+
+    return s.template count<T>();
+}
+
+//! Count the elements at logical indices `[first, last)` holding a `T`
+/** \pre  `first <= last && last <= s.size()`.
+ */
+template < typename T, typename ...Types >
+auto  count_alternative( tagged_union_soa<Types...> const &s, std::size_t
+ first, std::size_t last ) noexcept -> std::size_t
+{
+    static_assert( mpl::index_of_v<T, Types...>::value < sizeof...(Types),
+     "Not a variant type" );
+
+    typedef typename tagged_union_soa<Types...>::tag_type  tag_type;
+
+    return count_tag( s.tags() + first, s.tags() + last, static_cast<tag_type>(
+     s.template index_of<T>()) );
+}
+
+//! Find the first element, from logical index `from` on, holding a `T`
+/** \pre  `from <= s.size()`.
+
+    \returns  The match's logical index, or `s.size()` if there isn't one.
+ */
+template < typename T, typename ...Types >
+auto  find_alternative( tagged_union_soa<Types...> const &s, std::size_t from =
+ 0u ) noexcept -> std::size_t
+{
+    static_assert( mpl::index_of_v<T, Types...>::value < sizeof...(Types),
+     "Not a variant type" );
+
+    typedef typename tagged_union_soa<Types...>::tag_type  tag_type;
+
+    return find_tag( s.tags() + from, s.tags() + s.size(), static_cast<
+     tag_type>(s.template index_of<T>()) ) - s.tags();
+}
+
+//! Mark which elements hold a `T`, one bit each
+/** \pre  `bits` points to at least `(s.size() + 63) / 64` words.
+
+    \returns  The number of elements holding a `T`.
+
+    \see  mask_tag
+ */
+template < typename T, typename ...Types >
+auto  mask_alternative( tagged_union_soa<Types...> const &s, std::uint64_t
+ *bits ) noexcept -> std::size_t
+{
+    static_assert( mpl::index_of_v<T, Types...>::value < sizeof...(Types),
+     "Not a variant type" );
+
+    typedef typename tagged_union_soa<Types...>::tag_type  tag_type;
+
+    return mask_tag( s.tags(), s.tags() + s.size(), static_cast<tag_type>(
+     s.template index_of<T>()), bits );
+}
+
+//! Count the `tagged_union` objects in `[first, last)` holding a `T`
+template < typename T, typename InputIterator >
+auto  count_alternative( InputIterator first, InputIterator last )
+  -> std::size_t
+{
+    static_assert( detail::is_range_alternative<T, detail::union_range_value<
+     InputIterator>>::value, "Not a variant type" );
+
+    std::size_t const  index = detail::union_range_value<InputIterator>::
+     template index_of<T>();
+    std::size_t        result = 0u;
+
+    for ( ; first != last ; ++first )
+        result += ( first->stored_index() == index );
+    return result;
+}
+
+//! Find the first `tagged_union` object in `[first, last)` holding a `T`
+/** \returns  An iterator to the match, or `last` if there isn't one.
+ */
+template < typename T, typename InputIterator >
+auto  find_alternative( InputIterator first, InputIterator last )
+  -> InputIterator
+{
+    static_assert( detail::is_range_alternative<T, detail::union_range_value<
+     InputIterator>>::value, "Not a variant type" );
+
+    std::size_t const  index = detail::union_range_value<InputIterator>::
+     template index_of<T>();
+
+    while ( first != last && first->stored_index() != index )
+        ++first;
+    return first;
+}
+
+//! Mark which `tagged_union` objects in `[first, last)` hold a `T`
+/** \pre  `bits` points to a word for each 64 elements, rounded up.
+
+    \returns  The number of objects holding a `T`.
+
+    \see  mask_tag
+ */
+template < typename T, typename InputIterator >
+auto  mask_alternative( InputIterator first, InputIterator last, std::uint64_t
+ *bits ) -> std::size_t
+{
+    static_assert( detail::is_range_alternative<T, detail::union_range_value<
+     InputIterator>>::value, "Not a variant type" );
+
+    std::size_t const  index = detail::union_range_value<InputIterator>::
+     template index_of<T>();
+    std::size_t        result = 0u, i = 0u;
+    std::uint64_t      word = 0u;
+
+    for ( ; first != last ; ++first )
+    {
+        std::uint64_t const  match = ( first->stored_index() == index );
+
+        result += match;
+        word |= match << i;
+        if ( ++i == detail::tag_block )
+        {
+            *bits++ = word;
+            word = 0u;
+            i = 0u;
+        }
+    }
+    if ( i )
+        *bits = word;
+    return result;
+}
+//@}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#undef BOOST_UNIONS_DETAIL_TAG_SCAN_AVX2
+#undef BOOST_UNIONS_DETAIL_TAG_SCAN_SSE2
+
+#endif  // BOOST_UNIONS_TAG_SCAN_HPP
@@ -0,0 +1,275 @@
+//  Boost Unions Library, tagged_union_queue.hpp header file  ----------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A bounded, lock-free, multi-producer, multi-consumer queue of
+            `tagged_union` messages built and read in place.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definition of `tagged_union_queue`, a ring of `tagged_union`
+    slots, each with its own sequence number.  A producer builds its message
+    right in a slot, and a consumer visits it there, so a message is built
+    once and never copied.
+ */
+
+#ifndef BOOST_UNIONS_TAGGED_UNION_QUEUE_HPP
+#define BOOST_UNIONS_TAGGED_UNION_QUEUE_HPP
+
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/union_policy.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Tagged union queue class template definition  ----------------------------//
+
+//! Bounded lock-free queue of unions, for many producers and consumers
+/** A ring of `Capacity` slots, each a `Union` and a sequence number on a
+    cache line (or more) of its own, with a count of claims for each side.
+    A producer claims the slot at its count by compare-and-swap, when the
+    slot's sequence says it's free, builds the message in it with `emplace`,
+    then bumps the sequence to hand it to consumers.  A consumer claims a
+    full slot the same way, visits the message in place, empties the slot,
+    and bumps the sequence to hand it back.  No operation waits for a lock;
+    a full (or empty) queue makes the `try_` functions fail at once.
+
+    A slot stays claimed while its message is built or visited, so a
+    producer or consumer stalled there holds up the ones that come a lap
+    behind it, but no others.
+
+    The object is big (`Capacity` cache lines or more) and over-aligned, so
+    it is best given static storage or made a member of something that is
+    allocated with care for its alignment.
+
+    \tparam Union     The type of the messages.  Must be a `basic_tagged_union`
+                      or a type with its `emplace` and the `visit` function.
+    \tparam Capacity  The number of slots.  Must be a power of two, at least
+                      2.
+ */
+template < class Union, std::size_t Capacity >
+class tagged_union_queue
+{
+    static_assert( Capacity >= 2u && !(Capacity & (Capacity - 1u)), "The "
+     "capacity must be a power of two, at least 2" );
+
+    // A slot is free for the producer of lap "n" while its sequence is
+    // "n * Capacity + index," and full for the consumer while it's one more
+    struct alignas( BOOST_UNIONS_CACHE_LINE_SIZE )  slot
+    {
+        std::atomic<std::size_t>  sequence;
+        Union                     message;
+    };
+
+    // Hands a filled slot to consumers, even when filling it throws
+    struct publish
+    {
+        slot *  s;
+
+        ~publish()
+        {
+            s->sequence.store( s->sequence.load(std::memory_order_relaxed) +
+             1u, std::memory_order_release );
+        }
+    };
+
+    // Empties a consumed slot and hands it back, even when visiting throws
+    struct release
+    {
+        slot *       s;
+        std::size_t  next;
+
+        ~release()
+        {
+            s->message = Union{};
+            s->sequence.store( next, std::memory_order_release );
+        }
+    };
+
+    // Claim a slot from "count" whose sequence is "lag" past the claim
+    auto  claim( std::atomic<std::size_t> &count, std::size_t lag ) noexcept
+      -> slot *
+    {
+        std::size_t  c = count.load( std::memory_order_relaxed );
+
+        for ( ;; )
+        {
+            slot &  s = slots_[ c % Capacity ];
+            auto const  behind = static_cast<std::ptrdiff_t>( s.sequence.load(
+             std::memory_order_acquire ) - (c + lag) );
+
+            if ( !behind )
+            {
+                if ( count.compare_exchange_weak(c, c + 1u,
+                 std::memory_order_relaxed) )
+                    return &s;
+            }
+            else if ( behind < 0 )
+                return nullptr;
+            else
+                c = count.load( std::memory_order_relaxed );
+        }
+    }
+
+    // Fill a claimed slot with "build," and hand it to consumers even if that
+    // throws
+    template < typename Build >
+    bool  produce( Build build )
+    {
+        slot * const  s = this->claim( pushed_, 0u );
+
+        if ( !s )
+            return false;
+
+        publish const  p{ s };
+
+        build( s->message );
+        return true;
+    }
+
+public:
+    //! The type of the messages
+    typedef Union  value_type;
+
+    //! The number of messages the queue holds at most
+    static constexpr
+    auto  capacity() noexcept -> std::size_t  { return Capacity; }
+
+    //! Start empty
+    tagged_union_queue() noexcept
+        : pushed_{ 0u }, popped_{ 0u }
+    {
+        for ( std::size_t  i = 0u ; i < Capacity ; ++i )
+            slots_[ i ].sequence.store( i, std::memory_order_relaxed );
+    }
+
+    //! Can't be copied, since it's shared in place
+    tagged_union_queue( tagged_union_queue const & ) = delete;
+    //! Can't be assigned
+    auto  operator =( tagged_union_queue const & ) -> tagged_union_queue &
+      = delete;
+
+    //! Build a `T` from `args` in a free slot, unless the queue is full
+    /** If building throws, the slot is handed on empty, which consumers skip,
+        and the exception passes on.
+
+        \retval true   The message was added.
+        \retval false  The queue is full; nothing was built.
+     */
+    template < typename T, typename ...Args >
+    bool  try_emplace( Args &&...args )
+    {
+        return this->produce( [&]( Union &m ){
+            m.template emplace<T>( std::forward<Args>(args)... );
+        } );
+    }
+    //! Add a copy of `message`, unless the queue is full
+    /** \retval true   The message was added.
+        \retval false  The queue is full; nothing was done.
+     */
+    bool  try_push( Union const &message )
+    { return this->produce( [&]( Union &m ){ m = message; } ); }
+    //! Add `message`, moved, unless the queue is full
+    /** \retval true   The message was added.
+        \retval false  The queue is full; nothing was done.
+     */
+    bool  try_push( Union &&message )
+    { return this->produce( [&]( Union &m ){ m = std::move(message); } ); }
+
+    //! Call `visitor` with the oldest message, in place, then drop it
+    /** The message goes to `visitor` as for `visit(visitor, Union &)`, so it
+        can be moved out.  Empty slots (left by a failed `try_emplace`) are
+        dropped without a call.  The slot is emptied and handed back even if
+        `visitor` throws, and the exception passes on.
+
+        \retval true   A message was visited.
+        \retval false  The queue is empty; nothing was done.
+     */
+    template < typename Func >
+    bool  try_visit( Func &&visitor )
+    {
+        for ( ;; )
+        {
+            slot * const  s = this->claim( popped_, 1u );
+
+            if ( !s )
+                return false;
+
+            release const  r{ s, s->sequence.load(std::memory_order_relaxed)
+             - 1u + Capacity };
+
+            if ( s->message.stored_index() != s->message.empty_index() )
+            {
+                visit( std::forward<Func>(visitor), s->message );
+                return true;
+            }
+        }
+    }
+    //! Move the oldest message to `message`, unless the queue is empty
+    /** \retval true   A message was moved to `message`.
+        \retval false  The queue is empty; nothing was done.
+     */
+    bool  try_pop( Union &message )
+    {
+        for ( ;; )
+        {
+            slot * const  s = this->claim( popped_, 1u );
+
+            if ( !s )
+                return false;
+
+            release const  r{ s, s->sequence.load(std::memory_order_relaxed)
+             - 1u + Capacity };
+
+            if ( s->message.stored_index() != s->message.empty_index() )
+            {
+                message = std::move( s->message );
+                return true;
+            }
+        }
+    }
+
+    //! The number of messages waiting, roughly, when others are at work
+    auto  size() const noexcept -> std::size_t
+    {
+        std::size_t const  popped = popped_.load( std::memory_order_acquire );
+        std::size_t const  pushed = pushed_.load( std::memory_order_acquire );
+
+        return ( pushed > popped ) ? pushed - popped : 0u;
+    }
+    //! Check if no messages are waiting, roughly, when others are at work
+    bool  empty() const noexcept  { return !this->size(); }
+
+private:
+    // Member data; each count gets its own line, as does each slot
+    alignas( BOOST_UNIONS_CACHE_LINE_SIZE )
+    std::atomic<std::size_t>  pushed_;
+    alignas( BOOST_UNIONS_CACHE_LINE_SIZE )
+    std::atomic<std::size_t>  popped_;
+    slot                      slots_[ Capacity ];
+};
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_TAGGED_UNION_QUEUE_HPP
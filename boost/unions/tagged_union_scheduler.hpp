@@ -0,0 +1,556 @@
+//  Boost Unions Library, tagged_union_scheduler.hpp header file  ------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A work-stealing pool of threads running tasks from a closed set of
+            types, kept inline as `tagged_union` alternatives.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definition of `tagged_union_scheduler`, a thread pool whose
+    tasks are the alternatives of a `tagged_union`.  Each worker keeps its
+    tasks by value in a deque of its own, runs the newest, and steals the
+    oldest from others when it runs out; a task is run by one indexed call
+    through a table on its type, with no allocation and no type erasure.
+ */
+
+#ifndef BOOST_UNIONS_TAGGED_UNION_SCHEDULER_HPP
+#define BOOST_UNIONS_TAGGED_UNION_SCHEDULER_HPP
+
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/union_policy.hpp"
+#include <boost/integer.hpp>
+#include <boost/variant/get.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // A Chase-Lev deque of fixed-size images, "Capacity" of them at most.  The
+    // owner pushes and takes at the bottom; thieves take from the top.  The
+    // images are kept in relaxed atomic words, so a thief may read a slot the
+    // owner is reusing (its claim on the top then fails) without a data race.
+    template < std::size_t Words, std::size_t Capacity >
+    class task_deque
+    {
+        static_assert( Capacity >= 2u && !(Capacity & (Capacity - 1u)), "The "
+         "capacity must be a power of two, at least 2" );
+
+        typedef std::atomic<std::uint64_t>  word_type;
+
+        void  read( std::int64_t i, std::uint64_t *image ) const noexcept
+        {
+            word_type const * const  s = slots_[ static_cast<std::size_t>(i)
+             % Capacity ];
+
+            for ( std::size_t  w = 0u ; w < Words ; ++w )
+                image[ w ] = s[ w ].load( std::memory_order_relaxed );
+        }
+
+    public:
+        task_deque() noexcept
+            : top_{ 0 }, bottom_{ 0 }
+        { }
+
+        // Owner only; fails when full
+        bool  push( std::uint64_t const *image ) noexcept
+        {
+            std::int64_t const  b = bottom_.load( std::memory_order_relaxed );
+
+            if ( b - top_.load(std::memory_order_acquire) >= static_cast<
+             std::int64_t>(Capacity) )
+                return false;
+
+            word_type * const  s = slots_[ static_cast<std::size_t>(b) %
+             Capacity ];
+
+            for ( std::size_t  w = 0u ; w < Words ; ++w )
+                s[ w ].store( image[w], std::memory_order_relaxed );
+            bottom_.store( b + 1, std::memory_order_release );
+            return true;
+        }
+        // Owner only; the newest image, if any
+        bool  take( std::uint64_t *image ) noexcept
+        {
+            std::int64_t const  b = bottom_.load( std::memory_order_relaxed )
+             - 1;
+
+            bottom_.store( b, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+
+            std::int64_t  t = top_.load( std::memory_order_relaxed );
+            bool          result = t <= b;
+
+            if ( result )
+            {
+                this->read( b, image );
+                if ( t != b )
+                    return true;
+
+                // The last one; race the thieves for it
+                result = top_.compare_exchange_strong( t, t + 1,
+                 std::memory_order_seq_cst, std::memory_order_relaxed );
+            }
+            bottom_.store( b + 1, std::memory_order_relaxed );
+            return result;
+        }
+        // Any thread; the oldest image, unless there's none or another thief
+        // got it first
+        bool  steal( std::uint64_t *image ) noexcept
+        {
+            std::int64_t  t = top_.load( std::memory_order_acquire );
+
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            if ( t >= bottom_.load(std::memory_order_acquire) )
+                return false;
+            this->read( t, image );
+            return top_.compare_exchange_strong( t, t + 1,
+             std::memory_order_seq_cst, std::memory_order_relaxed );
+        }
+
+        // Roughly, when others are at work
+        bool  empty() const noexcept
+        {
+            return top_.load( std::memory_order_acquire ) >= bottom_.load(
+             std::memory_order_acquire );
+        }
+
+    private:
+        // Member data; thieves write the first line, the owner the others
+        unsigned char              before_[ BOOST_UNIONS_CACHE_LINE_SIZE ];
+        std::atomic<std::int64_t>  top_;
+        unsigned char              between_[ BOOST_UNIONS_CACHE_LINE_SIZE ];
+        std::atomic<std::int64_t>  bottom_;
+        word_type                  slots_[ Capacity ][ Words ];
+        unsigned char              after_[ BOOST_UNIONS_CACHE_LINE_SIZE ];
+    };
+}
+//! \endcond
+
+
+//  Tagged union scheduler class template definition  ------------------------//
+
+/** \brief  A work-stealing thread pool whose tasks are the alternatives of
+            `Union`
+
+    Only the specialization for `basic_tagged_union` is defined.
+ */
+template < class Union, std::size_t Capacity = 1024u >
+class tagged_union_scheduler;
+
+//! Work-stealing thread pool running the alternatives of a `tagged_union`
+/** Each task is an object of one of `Types`, called with the `worker` running
+    it as `task(w)`; it can `spawn` more tasks from there, and wait for them
+    with `help_until`.  A task is kept as a compact image (the index of its
+    type, then its bytes), by value, in a fixed-size deque of `Capacity`
+    slots per worker: no allocation, and no indirect call but the one through
+    a table on the type's index that runs it.
+
+    A worker runs the newest task of its own deque, which keeps recursive
+    (fork/join) work depth-first and in cache.  Out of those, it takes a task
+    from the pool's inbox of `submit`ted tasks, then steals the oldest task
+    of another worker, whose deque's top is changed only by compare-and-swap.
+    A worker finding no work yields for a while, then sleeps until a spawn or
+    a submission wakes it (or for a millisecond, whichever comes first).
+
+    When a worker's deque is full, a task it spawns is run at once instead,
+    as if called, so spawning never fails and never allocates.
+
+    Tasks are copied as bytes and may be run on any worker thread, so each
+    type must be trivially copyable, and should be small.  A task holding
+    more state keeps a pointer to it.  An exception escaping a task ends the
+    program, as it does from a `std::thread`; tasks still waiting when the
+    pool is destroyed are dropped.
+
+    \tparam Policy    The storage policy of the union.
+    \tparam Types     The task types.  Each must be trivially copyable and
+                      callable with a `worker &`.
+    \tparam Capacity  The number of slots in each worker's deque.  Must be a
+                      power of two, at least 2.
+ */
+template < class Policy, typename ...Types, std::size_t Capacity >
+class tagged_union_scheduler< basic_tagged_union<Policy, Types...>, Capacity >
+{
+    static_assert( detail::all_of<std::is_trivially_copyable<Types>::value...
+     >::value, "Every task type must be trivially copyable" );
+
+    typedef typename boost::uint_value_t<sizeof...( Types )>::least  tag_type;
+
+    static constexpr  std::size_t  image_words = ( sizeof(tag_type) +
+     detail::max_of(0u, sizeof( Types )...) + 7u ) / 8u;
+
+    // A task's image: its type's index, then its bytes, then zeroes
+    struct image_type
+    {
+        std::uint64_t  words[ image_words ];
+    };
+
+    typedef detail::task_deque<image_words, Capacity>  deque_type;
+
+    // Idle rounds a worker yields for before it sleeps
+    static constexpr  unsigned  spins = 64u;
+
+public:
+    class worker;
+
+    //! The type of the tasks, as a union
+    typedef basic_tagged_union<Policy, Types...>  value_type;
+
+    //! The number of tasks each worker's deque holds at most
+    static constexpr
+    auto  capacity() noexcept -> std::size_t  { return Capacity; }
+
+    //! A worker thread's side of the pool, given to each task it runs
+    class worker
+    {
+        friend class tagged_union_scheduler;
+
+        worker( tagged_union_scheduler &pool, std::size_t index ) noexcept
+            : pool_{ &pool }, index_{ index }, seed_{ index * 2u + 1u }
+        { }
+
+    public:
+        //! The type of the tasks, as a union
+        typedef typename tagged_union_scheduler::value_type  value_type;
+
+        //! Can't be copied, since other workers steal from it in place
+        worker( worker const & ) = delete;
+        //! Can't be assigned
+        auto  operator =( worker const & ) -> worker & = delete;
+
+        //! The worker's place in the pool, from 0 to `size() - 1`
+        auto  index() const noexcept -> std::size_t  { return index_; }
+        //! The pool the worker belongs to
+        auto  pool() const noexcept -> tagged_union_scheduler &
+        { return *pool_; }
+
+        //! Add a `T` built from `args` to this worker's tasks
+        /** Run at once if the deque is full.
+
+            \throws  Whatever building the `T` throws.
+         */
+        template < typename T, typename ...Args >
+        void  spawn( Args &&...args )
+        {
+            T const  task{ std::forward<Args>(args)... };
+
+            this->push( make_image(index_of<T>(), &task) );
+        }
+        //! Add a copy of the task in `task` to this worker's tasks
+        /** Run at once if the deque is full.  An empty `task` is ignored.
+
+            \throws  boost::bad_get  if `task` stores a pointer-to-self.
+         */
+        void  spawn( value_type const &task )
+        {
+            if ( task.stored_index() < sizeof...(Types) )
+                this->push( make_image(task) );
+            else if ( task.storing_pointer_to_self() )
+                throw bad_get{};
+        }
+
+        //! Run tasks, this worker's or others', until `done()` is true
+        /** For a task waiting on tasks it spawned, e.g. by a count they
+            decrease; it keeps the thread busy, and finishes them itself if no
+            one stole them.
+
+            \throws  Whatever `done` throws.
+         */
+        template < typename Predicate >
+        void  help_until( Predicate &&done )
+        {
+            while ( !done() )
+                if ( !this->run_one() )
+                    std::this_thread::yield();
+        }
+
+    private:
+        void  push( image_type const &image )
+        {
+            if ( deque_.push(image.words) )
+                pool_->wake();
+            else
+                this->run( image );
+        }
+
+        void  run( image_type const &image )
+        {
+            static void (* const  table[])( unsigned char const *, worker & )
+             = { &run_task<Types>... };
+            auto const  bytes = reinterpret_cast<unsigned char const *>(
+             image.words );
+            tag_type    tag;
+
+            std::memcpy( &tag, bytes, sizeof(tag) );
+            table[ tag ]( bytes + sizeof(tag), *this );
+        }
+
+        // Own tasks first, newest first; then the inbox; then the others'
+        bool  run_one()
+        {
+            image_type  image;
+
+            if ( deque_.take(image.words) || pool_->take_submitted(image) ||
+             this->steal(image) )
+            {
+                this->run( image );
+                return true;
+            }
+            return false;
+        }
+
+        // Try every other worker once, from one picked at random
+        bool  steal( image_type &image ) noexcept
+        {
+            std::size_t const  n = pool_->workers_.size();
+
+            if ( n < 2u )
+                return false;
+            seed_ ^= seed_ << 13;
+            seed_ ^= seed_ >> 7;
+            seed_ ^= seed_ << 17;
+            for ( std::size_t  i = 0u, v = seed_ % n ; i < n ; ++i, v = ( v +
+             1u ) % n )
+                if ( v != index_ && pool_->workers_[v]->deque_.steal(
+                 image.words) )
+                    return true;
+            return false;
+        }
+
+        void  work()
+        {
+            unsigned  idle = 0u;
+
+            while ( !pool_->stopping_.load(std::memory_order_acquire) )
+                if ( this->run_one() )
+                    idle = 0u;
+                else if ( ++idle < spins )
+                    std::this_thread::yield();
+                else
+                    pool_->sleep();
+        }
+
+        // Member data
+        deque_type                deque_;
+        tagged_union_scheduler *  pool_;
+        std::size_t               index_;
+        std::uint64_t             seed_;
+    };
+
+    //! Start `threads` workers (at least one)
+    /** \throws  std::system_error  if a thread can't be started, or
+                 std::bad_alloc.
+     */
+    explicit  tagged_union_scheduler( std::size_t threads =
+     std::thread::hardware_concurrency() )
+        : stopping_{ false }, submitted_count_{ 0u }, sleepers_{ 0u }
+    {
+        threads = threads ? threads : 1u;
+        workers_.reserve( threads );
+        for ( std::size_t  i = 0u ; i < threads ; ++i )
+            workers_.emplace_back( new worker(*this, i) );
+
+        struct stopper
+        {
+            tagged_union_scheduler *  pool;
+
+            ~stopper()  { if ( pool )  pool->stop(); }
+        }  s{ this };
+
+        threads_.reserve( threads );
+        for ( std::size_t  i = 0u ; i < threads ; ++i )
+            threads_.emplace_back( &worker::work, workers_[i].get() );
+        s.pool = nullptr;
+    }
+    //! Stop the workers, once their current tasks end; waiting tasks are
+    //! dropped
+    ~tagged_union_scheduler()  { this->stop(); }
+
+    //! Can't be copied, since its workers point to it
+    tagged_union_scheduler( tagged_union_scheduler const & ) = delete;
+    //! Can't be assigned
+    auto  operator =( tagged_union_scheduler const & ) -> tagged_union_scheduler
+      & = delete;
+
+    //! The number of workers
+    auto  size() const noexcept -> std::size_t  { return workers_.size(); }
+
+    //! Hand a `T` built from `args` to the pool, from outside it
+    /** Tasks should `spawn` from a worker instead, which doesn't lock.
+
+        \throws  Whatever building the `T` throws, or std::bad_alloc.
+     */
+    template < typename T, typename ...Args >
+    void  submit( Args &&...args )
+    {
+        T const  task{ std::forward<Args>(args)... };
+
+        this->put( make_image(index_of<T>(), &task) );
+    }
+    //! Hand a copy of the task in `task` to the pool, from outside it
+    /** An empty `task` is ignored.
+
+        \throws  boost::bad_get  if `task` stores a pointer-to-self, or
+                 std::bad_alloc.
+     */
+    void  submit( value_type const &task )
+    {
+        if ( task.stored_index() < sizeof...(Types) )
+            this->put( make_image(task) );
+        else if ( task.storing_pointer_to_self() )
+            throw bad_get{};
+    }
+
+    //! Wait, from outside the pool, until `done()` is true
+    /** The calling thread yields between checks; it runs no tasks.
+
+        \throws  Whatever `done` throws.
+     */
+    template < typename Predicate >
+    void  wait_until( Predicate &&done ) const
+    {
+        while ( !done() )
+            std::this_thread::yield();
+    }
+
+private:
+    template < typename T >
+    static constexpr
+    auto  index_of() noexcept -> std::size_t
+    {
+        static_assert( mpl::index_of_v<T, Types...>::value < sizeof...(Types),
+         "Not a task type" );
+        return mpl::index_of_v<T, Types...>::value;
+    }
+
+    static  auto  make_image( std::size_t index, void const *task ) noexcept
+      -> image_type
+    {
+        static std::size_t const  sizes[] = { sizeof(Types)... };
+        image_type                result = {};
+        tag_type const            tag = static_cast<tag_type>( index );
+        auto const                bytes = reinterpret_cast<unsigned char *>(
+         result.words );
+
+        std::memcpy( bytes, &tag, sizeof(tag) );
+        std::memcpy( bytes + sizeof(tag), task, sizes[index] );
+        return result;
+    }
+    static  auto  make_image( value_type const &task ) noexcept -> image_type
+    { return make_image( task.stored_index(), task.data() ); }
+
+    template < typename T >
+    static  void  run_task( unsigned char const *bytes, worker &w )
+    {
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+        std::memcpy( &b, bytes, sizeof(T) );
+        ( *reinterpret_cast<T *>(&b) )( w );
+    }
+
+    void  put( image_type const &image )
+    {
+        {
+            std::lock_guard<std::mutex>  lock{ submitted_mutex_ };
+
+            submitted_.push_back( image );
+            submitted_count_.fetch_add( 1u, std::memory_order_release );
+        }
+        this->wake();
+    }
+    bool  take_submitted( image_type &image )
+    {
+        if ( !submitted_count_.load(std::memory_order_acquire) )
+            return false;
+
+        std::lock_guard<std::mutex>  lock{ submitted_mutex_ };
+
+        if ( submitted_.empty() )
+            return false;
+        image = submitted_.front();
+        submitted_.pop_front();
+        submitted_count_.fetch_sub( 1u, std::memory_order_relaxed );
+        return true;
+    }
+
+    // A wake-up can be missed by a worker just going to sleep, so sleeps are
+    // short
+    void  wake()
+    {
+        if ( sleepers_.load(std::memory_order_seq_cst) )
+            awake_.notify_one();
+    }
+    void  sleep()
+    {
+        std::unique_lock<std::mutex>  lock{ sleep_mutex_ };
+
+        sleepers_.fetch_add( 1u, std::memory_order_seq_cst );
+        if ( !stopping_.load(std::memory_order_acquire) )
+            awake_.wait_for( lock, std::chrono::milliseconds(1) );
+        sleepers_.fetch_sub( 1u, std::memory_order_relaxed );
+    }
+
+    void  stop()
+    {
+        {
+            std::lock_guard<std::mutex>  lock{ sleep_mutex_ };
+
+            stopping_.store( true, std::memory_order_release );
+        }
+        awake_.notify_all();
+        for ( std::thread &t : threads_ )
+            t.join();
+        threads_.clear();
+    }
+
+    // Member data
+    std::vector<std::unique_ptr<worker>>  workers_;
+    std::vector<std::thread>              threads_;
+    std::atomic<bool>                     stopping_;
+    std::mutex                            submitted_mutex_;
+    std::deque<image_type>                submitted_;
+    std::atomic<std::size_t>              submitted_count_;
+    std::mutex                            sleep_mutex_;
+    std::condition_variable               awake_;
+    std::atomic<unsigned>                 sleepers_;
+};
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_TAGGED_UNION_SCHEDULER_HPP
@@ -0,0 +1,332 @@
+//  Boost Unions Library, tagged_union_snapshot.hpp header file  -------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A cell publishing immutable versions of a `tagged_union` to
+            readers that never wait.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definition of `tagged_union_snapshot`, which holds the
+    current version of a (typically large) `tagged_union` value, such as a
+    configuration or a routing table.  Readers look at a version in place,
+    without locking or copying, while writers publish new versions; an old
+    version is destroyed once no reader can still be looking at it, as
+    tracked by epochs.
+ */
+
+#ifndef BOOST_UNIONS_TAGGED_UNION_SNAPSHOT_HPP
+#define BOOST_UNIONS_TAGGED_UNION_SNAPSHOT_HPP
+
+#include "boost/unions/union_policy.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Tagged union snapshot class template definition  -------------------------//
+
+//! A cell of versions of a union, read wait-free and reclaimed by epochs
+/** Each version is an immutable `Union` on the heap, and the cell points to
+    the current one.  A reader takes a `reader` handle from the cell, once
+    per thread, then calls `reader::read` for a `view` of the current version,
+    which stays valid, unchanged, as long as the view exists.  Taking a view
+    reads the cell's epoch, stores it in the handle's slot, and reads the
+    version pointer; ending it stores to the slot again.  Each slot has its
+    own cache line, so readers never write anything another thread reads
+    often, and add no contention to each other.
+
+    A writer publishes a new version with `store` or `emplace`, which swaps
+    the pointer, advances the epoch, and retires the old version.  Retired
+    versions are destroyed, by later writes or `reclaim`, once every slot is
+    idle or holds a later epoch, i.e. once every view that may have seen them
+    has ended.  Writers are serialized by a mutex; readers never see it.
+
+    A view held forever keeps every later-retired version alive, so views
+    should be short.  The cell must outlive its handles, and a handle its
+    views.
+
+    \tparam Union  The type of the values kept.  Usually a `tagged_union`, but
+                   any type that can be built by copy, move, or emplacement
+                   works.
+ */
+template < class Union >
+class tagged_union_snapshot
+{
+    typedef std::uint_least64_t  epoch_type;
+
+    // A reader's announcement, alone on its cache line; "epoch" is 0 while
+    // idle, else the cell's epoch when the current view began
+    struct slot
+    {
+        unsigned char            before[ BOOST_UNIONS_CACHE_LINE_SIZE ];
+        std::atomic<epoch_type>  epoch;
+        std::atomic<bool>        used;
+        slot *                   next;
+        unsigned char            after[ BOOST_UNIONS_CACHE_LINE_SIZE ];
+    };
+
+    // A version waiting for its readers to leave, retired at "epoch"
+    struct retiree
+    {
+        std::unique_ptr<Union const>  version;
+        epoch_type                    epoch;
+    };
+
+public:
+    //! The type of the values kept
+    typedef Union  value_type;
+
+    class reader;
+
+    //! A reader's access to one version, which lasts as long as this object
+    class view
+    {
+        friend class reader;
+
+        view( Union const *version, std::atomic<epoch_type> *slot ) noexcept
+            : version_{ version }, slot_{ slot }
+        { }
+
+    public:
+        //! Take over `that` view, which then has nothing
+        view( view &&that ) noexcept
+            : version_{ that.version_ }, slot_{ that.slot_ }
+        { that.slot_ = nullptr; }
+        //! End the view, letting its version be reclaimed
+        ~view()
+        {
+            if ( slot_ )
+                slot_->store( 0u, std::memory_order_release );
+        }
+
+        //! Can't be copied, since it owns its reader's slot
+        view( view const & ) = delete;
+        //! Can't be assigned
+        auto  operator =( view const & ) -> view & = delete;
+
+        //! The version
+        auto  get() const noexcept -> Union const &  { return *version_; }
+        //! The version
+        auto  operator *() const noexcept -> Union const &
+        { return *version_; }
+        //! The version, for member access
+        auto  operator ->() const noexcept -> Union const *
+        { return version_; }
+
+    private:
+        Union const *              version_;
+        std::atomic<epoch_type> *  slot_;
+    };
+
+    //! A reader's slot in the cell, to be kept by one thread and reused
+    class reader
+    {
+        friend class tagged_union_snapshot;
+
+        reader( tagged_union_snapshot &cell, slot &s ) noexcept
+            : cell_{ &cell }, slot_{ &s }
+        { }
+
+    public:
+        //! Take over `that` handle, which then can't read
+        reader( reader &&that ) noexcept
+            : cell_{ that.cell_ }, slot_{ that.slot_ }
+        { that.slot_ = nullptr; }
+        //! Give the slot back to the cell, for another reader
+        ~reader()
+        {
+            if ( slot_ )
+                slot_->used.store( false, std::memory_order_release );
+        }
+
+        //! Can't be copied, since it owns its slot
+        reader( reader const & ) = delete;
+        //! Can't be assigned
+        auto  operator =( reader const & ) -> reader & = delete;
+
+        //! View the current version, wait-free
+        /** Only one view per handle may exist at a time.
+         */
+        auto  read() const noexcept -> view
+        {
+            slot_->epoch.store( cell_->epoch_.load(std::memory_order_seq_cst),
+             std::memory_order_seq_cst );
+            return view{ cell_->current_.load(std::memory_order_seq_cst),
+             &slot_->epoch };
+        }
+
+    private:
+        tagged_union_snapshot *  cell_;
+        slot *                   slot_;
+    };
+
+    //! Start with a version built from `args`
+    /** \throws  Whatever building a `Union` from `args`, or allocating, throws.
+     */
+    template <
+        typename ...Args,
+        class EnableIf = typename std::enable_if<std::is_constructible<Union,
+         Args...>::value>::type
+    >
+    explicit  tagged_union_snapshot( Args &&...args )
+        : current_{ new Union(std::forward<Args>( args )...) }, epoch_{ 1u },
+          slots_{ nullptr }
+    { }
+    //! Destroy every version, and every slot
+    /** No handle may remain.
+     */
+    ~tagged_union_snapshot()
+    {
+        delete current_.load( std::memory_order_relaxed );
+        for ( slot *s = slots_.load(std::memory_order_relaxed) ; s ; )
+        {
+            slot * const  next = s->next;
+
+            delete s;
+            s = next;
+        }
+    }
+
+    //! Can't be copied, since readers point into it
+    tagged_union_snapshot( tagged_union_snapshot const & ) = delete;
+    //! Can't be assigned
+    auto  operator =( tagged_union_snapshot const & ) -> tagged_union_snapshot &
+      = delete;
+
+    //! Get a handle for reading, reusing a slot given back if there's one
+    /** Lock-free; meant to be done once per reading thread.
+
+        \throws  std::bad_alloc  if a new slot can't be allocated.
+     */
+    auto  make_reader() -> reader
+    {
+        slot *  head = slots_.load( std::memory_order_acquire );
+
+        for ( slot *s = head ; s ; s = s->next )
+        {
+            bool  idle = false;
+
+            if ( !s->used.load(std::memory_order_relaxed) && s->used.
+             compare_exchange_strong(idle, true, std::memory_order_acquire) )
+                return reader{ *this, *s };
+        }
+
+        slot * const  s = new slot;
+
+        s->epoch.store( 0u, std::memory_order_relaxed );
+        s->used.store( true, std::memory_order_relaxed );
+        s->next = head;
+        while ( !slots_.compare_exchange_weak(s->next, s,
+         std::memory_order_release, std::memory_order_relaxed) )
+            ;
+        return reader{ *this, *s };
+    }
+
+    //! Publish a copy of `value` as the new version
+    /** \throws  Whatever copying `value`, or allocating, throws; the current
+                 version stays then.
+     */
+    void  store( Union const &value )  { this->publish( new Union(value) ); }
+    //! Publish `value`, moved, as the new version
+    /** \throws  Whatever moving `value`, or allocating, throws; the current
+                 version stays then.
+     */
+    void  store( Union &&value )
+    { this->publish( new Union(std::move( value )) ); }
+    //! Publish a version built from `args`
+    /** \throws  Whatever building a `Union` from `args`, or allocating,
+                 throws; the current version stays then.
+     */
+    template < typename ...Args >
+    void  emplace( Args &&...args )
+    { this->publish( new Union(std::forward<Args>( args )...) ); }
+
+    //! Destroy the retired versions no reader can be looking at
+    /** \returns  The number of retired versions left, still in view.
+     */
+    auto  reclaim() -> std::size_t
+    {
+        std::lock_guard<std::mutex>  lock{ writer_ };
+
+        return this->collect();
+    }
+
+private:
+    // Call with "writer_" held
+    auto  collect() -> std::size_t
+    {
+        // The oldest epoch a view may have begun in
+        epoch_type  oldest = epoch_.load( std::memory_order_seq_cst );
+
+        for ( slot *s = slots_.load(std::memory_order_acquire) ; s ; s =
+         s->next )
+        {
+            epoch_type const  e = s->epoch.load( std::memory_order_seq_cst );
+
+            if ( e && e < oldest )
+                oldest = e;
+        }
+
+        // A version retired at "e" was current to views of epoch "e" and
+        // before
+        std::size_t  kept = 0u;
+
+        for ( retiree &r : retired_ )
+            if ( r.epoch >= oldest )
+                retired_[ kept++ ] = std::move( r );
+        retired_.erase( retired_.begin() + kept, retired_.end() );
+        return kept;
+    }
+
+    void  publish( Union const *version )
+    {
+        std::unique_ptr<Union const>  next{ version };
+        std::lock_guard<std::mutex>   lock{ writer_ };
+
+        retired_.reserve( retired_.size() + 1u );
+
+        std::unique_ptr<Union const>  old{ current_.exchange(next.release(),
+         std::memory_order_seq_cst) };
+
+        retired_.push_back( retiree{std::move( old ), epoch_.fetch_add(1u,
+         std::memory_order_seq_cst)} );
+        this->collect();
+    }
+
+    // Member data
+    std::atomic<Union const *>  current_;
+    std::atomic<epoch_type>     epoch_;
+    std::atomic<slot *>         slots_;
+    std::mutex                  writer_;
+    std::vector<retiree>        retired_;
+};
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_TAGGED_UNION_SNAPSHOT_HPP
@@ -0,0 +1,293 @@
+//  Boost Unions Library, tagged_union_soa.hpp header file  ------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A sequence of tagged-union values, stored as one array per type.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions of `tagged_union_soa`, a container
+    that holds what a `std::vector` of `tagged_union` would, but keeps the tags
+    in a dense array of their own and the objects of each variant type in a
+    contiguous array of that type (a "structure of arrays").  A pass over the
+    objects of one type reads only those objects.
+ */
+
+#ifndef BOOST_UNIONS_TAGGED_UNION_SOA_HPP
+#define BOOST_UNIONS_TAGGED_UNION_SOA_HPP
+
+#include "boost/mpl/contains_v.hpp"
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/mpl/type_at_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/utility/index_sequence11.hpp"
+#include <boost/integer.hpp>
+#include <boost/variant/get.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Structure-of-arrays tagged union container class template definition  ---//
+
+//! Sequence of `tagged_union` values with each variant type stored apart
+/** Elements are addressed by a logical index, like a `std::vector` of
+    `tagged_union<Types...>`, but are stored as:
+
+    - a dense array of tags, the smallest unsigned type that can hold every
+      index, one per element;
+    - an array of positions, one per element, saying where the element's
+      object is within the array for its type; and
+    - one contiguous array for each of `Types`, holding that type's objects
+      in the order they were added.
+
+    So a pass over the objects of one type, with `for_each` or `data`, reads
+    one dense array and nothing else; when the operation is simple enough,
+    the compiler can vectorize it.  Elements are only ever appended, so a
+    logical index stays valid (and keeps referring to the same object) until
+    `clear`.
+
+    Empty elements are allowed, and take no space in any type's array.  There
+    are no pointers-to-self; pushing a `tagged_union` that stores one is an
+    error.
+
+    \tparam Types  The variant types of the elements.  There must be at least
+                   one, and each must be movable.  If a type repeats, the
+                   first one's array is used, like `tagged_union`'s access
+                   functions do.
+ */
+template < typename ...Types >
+class tagged_union_soa
+{
+    typedef boost::make_index_sequence<sizeof...( Types )>  indices_type;
+
+public:
+    //! The type of the elements, when taken out as a whole
+    typedef tagged_union<Types...>  value_type;
+    //! The type for sizes and logical indices
+    typedef std::size_t  size_type;
+    //! The type of the tags, the smallest unsigned type holding every index
+    typedef typename boost::uint_value_t<sizeof...(Types)>::least  tag_type;
+
+    //! Returns the index `stored_index` uses for type `T`.
+    /** \returns  The index of `T` within `Types` if it's there, otherwise
+                  `#empty_index()`.
+     */
+    template < typename T >
+    static constexpr
+    auto  index_of() noexcept -> std::size_t
+    { return mpl::index_of_v<T, Types...>::value; }
+    //! Returns the index used by `stored_index` for an empty element.
+    static constexpr
+    auto  empty_index() noexcept -> std::size_t
+    { return sizeof...( Types ); }
+
+    //! Returns the number of elements, of all types and empty ones.
+    auto  size() const noexcept -> size_type  { return tags_.size(); }
+    //! Checks if there are no elements.
+    bool  empty() const noexcept  { return tags_.empty(); }
+    //! Returns the number of elements holding a `T`.
+    template < typename T >
+    auto  count() const noexcept -> size_type
+    { return this->template array<T>().size(); }
+
+    //! Reserve room for the tags and positions of `n` elements
+    void  reserve( size_type n )
+    {
+        tags_.reserve( n );
+        positions_.reserve( n );
+    }
+    //! Reserve room in the array of `T` objects
+    template < typename T >
+    void  reserve( size_type n )  { this->template array<T>().reserve( n ); }
+
+    //! Remove all the elements, keeping the arrays' storage
+    void  clear() noexcept
+    {
+        tags_.clear();
+        positions_.clear();
+        this->clear_arrays( indices_type{} );
+    }
+
+    //! Append an element holding a `T` built from `args`
+    /** \returns  The new element's logical index.
+     */
+    template < typename T, typename ...Args >
+    auto  emplace_back( Args&& ...args )
+      -> typename std::enable_if<mpl::contains_v<T, Types...>::value,
+       size_type>::type
+    {
+        auto &  a = this->template array<T>();
+
+        make_room( positions_ );
+        make_room( tags_ );
+        a.emplace_back( std::forward<Args>(args)... );
+        positions_.push_back( a.size() - 1u );
+        tags_.push_back( static_cast<tag_type>(index_of<T>()) );
+        return tags_.size() - 1u;
+    }
+    //! Append an element holding a copy of `x`
+    template < typename T, class EnableIf = typename std::enable_if<
+     mpl::contains_v<typename std::decay<T>::type, Types...>::value>::type >
+    auto  push_back( T &&x ) -> size_type
+    {
+        return this->template emplace_back<typename std::decay<T>::type>(
+         std::forward<T>(x) );
+    }
+    //! Append an element with the state of `u`
+    /** \throws  boost::bad_get  if `u` stores a pointer to itself.
+     */
+    auto  push_back( value_type const &u ) -> size_type
+    {
+        static  auto (* const  table[])( tagged_union_soa &, value_type const
+         & ) -> size_type = { &push_state<Types>... };
+
+        if ( u.stored_index() < sizeof...(Types) )
+            return table[ u.stored_index() ]( *this, u );
+        else if ( u.stored_index() == value_type::empty_index() )
+            return this->push_empty();
+        throw bad_get{};
+    }
+    //! Append an empty element
+    auto  push_empty() -> size_type
+    {
+        make_room( positions_ );
+        tags_.push_back( static_cast<tag_type>(empty_index()) );
+        positions_.push_back( 0u );
+        return tags_.size() - 1u;
+    }
+
+    //! Check the index of the type stored at logical index `i`
+    auto  stored_index( size_type i ) const noexcept -> std::size_t
+    { return tags_[ i ]; }
+    //! The dense tag array, one tag per element
+    auto  tags() const noexcept -> tag_type const *  { return tags_.data(); }
+
+    //! Access the `T` at logical index `i`, NULL if it's not a `T`
+    template < typename T >
+    auto  gett( size_type i ) noexcept -> T *
+    {
+        return ( tags_[i] == index_of<T>() ) ? this->template array<T>().data()
+         + positions_[ i ] : nullptr;
+    }
+    //! \overload
+    template < typename T >
+    auto  gett( size_type i ) const noexcept -> T const *
+    { return const_cast<tagged_union_soa *>( this )->template gett<T>( i ); }
+    //! Copy out the element at logical index `i` as a union
+    auto  at( size_type i ) const -> value_type
+    {
+        static  auto (* const  table[])( tagged_union_soa const &, size_type )
+         -> value_type = { &copy_state<Types>..., &copy_empty };
+
+        return table[ tags_[i] ]( *this, i );
+    }
+
+    //! The contiguous array of the `T` objects, in the order added
+    template < typename T >
+    auto  data() noexcept -> T *
+    { return this->template array<T>().data(); }
+    //! \overload
+    template < typename T >
+    auto  data() const noexcept -> T const *
+    { return this->template array<T>().data(); }
+
+    //! Call `kernel` on each `T` object, in the order added
+    /** The loop runs straight down the contiguous array of `T`, touching no
+        other element, so it can be vectorized when `kernel` is simple.
+
+        \returns  `kernel`, after its calls.
+     */
+    template < typename T, typename Kernel >
+    auto  for_each( Kernel kernel ) -> Kernel
+    {
+        auto &  a = this->template array<T>();
+
+        for ( T *p = a.data(), * const e = p + a.size() ; p != e ; ++p )
+            kernel( *p );
+        return kernel;
+    }
+    //! \overload
+    template < typename T, typename Kernel >
+    auto  for_each( Kernel kernel ) const -> Kernel
+    {
+        auto const &  a = this->template array<T>();
+
+        for ( T const *p = a.data(), * const e = p + a.size() ; p != e ; ++p )
+            kernel( *p );
+        return kernel;
+    }
+
+private:
+    template < typename T >
+    auto  array() noexcept -> std::vector<T> &
+    {
+        static_assert( mpl::contains_v<T, Types...>::value, "The type isn't "
+         "one of the element types" );
+
+        return std::get<index_of<T>()>( arrays_ );
+    }
+    template < typename T >
+    auto  array() const noexcept -> std::vector<T> const &
+    { return const_cast<tagged_union_soa *>( this )->template array<T>(); }
+
+    // Ensure the next push_back can't throw, still growing geometrically
+    template < typename T >
+    static  void  make_room( std::vector<T> &v )
+    {
+        if ( v.size() == v.capacity() )
+            v.reserve( v.empty() ? 16u : 2u * v.size() );
+    }
+
+    template < std::size_t ...Indices >
+    void  clear_arrays( boost::index_sequence<Indices...> ) noexcept
+    {
+        int const  dummy[] = { 0, (std::get<Indices>( arrays_ ).clear(),
+         0)... };
+
+        static_cast<void>( dummy );
+    }
+
+    template < typename T >
+    static  auto  push_state( tagged_union_soa &s, value_type const &u )
+      -> size_type
+    { return s.template emplace_back<T>( unions::gett<T>(u) ); }
+    template < typename T >
+    static  auto  copy_state( tagged_union_soa const &s, size_type i )
+      -> value_type
+    { return value_type{ *s.template gett<T>(i) }; }
+    static  auto  copy_empty( tagged_union_soa const &, size_type )
+      -> value_type
+    { return value_type{}; }
+
+    // Member data
+    std::vector<tag_type>              tags_;       // index of each's type
+    std::vector<size_type>             positions_;  // place in type's array
+    std::tuple<std::vector<Types>...>  arrays_;     // the objects, by type
+};
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_TAGGED_UNION_SOA_HPP
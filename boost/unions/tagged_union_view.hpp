@@ -0,0 +1,245 @@
+//  Boost Unions Library, tagged_union_view.hpp header file  -----------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  A read-only view of a saved `tagged_union`, in its archive bytes.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declaration and definitions of `tagged_union_view`, which
+    reads a `tagged_union` record written by `save` (from
+    "boost/unions/union_archive.hpp") where it lies, e.g. in a memory-mapped
+    file, and of its access functions `gett` and `visit`.  Checking a record's
+    type, or stepping over it, reads only its index.
+ */
+
+#ifndef BOOST_UNIONS_TAGGED_UNION_VIEW_HPP
+#define BOOST_UNIONS_TAGGED_UNION_VIEW_HPP
+
+#include "boost/mpl/index_of_v.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/unions/union_archive.hpp"
+#include <boost/variant/get.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Tagged union view class template definition  -----------------------------//
+
+//! Read-only view of a saved `tagged_union` record, without loading it
+/** The view is a pointer to the record's bytes (its index, then its member)
+    and the index already read; nothing is constructed.  A member is read
+    right from the buffer when its address is aligned for its type, and is
+    copied out otherwise.  (Records are packed, so whether a member is aligned
+    depends on what comes before it.)
+
+    Every type must have a bitwise `member_codec`, which is what makes a
+    member's bytes usable in place and its size known without reading it.
+    The bytes must stay put, and unchanged, while the view is used.
+
+    \tparam Types  The variant types of the `tagged_union` that was saved, in
+                   the same order.  Its policy doesn't matter.
+ */
+template < typename ...Types >
+class tagged_union_view
+{
+    static_assert( detail::all_bitwise<Types...>::value, "Every type needs a "
+     "bitwise member_codec" );
+
+    typedef detail::archive_tag<sizeof...( Types )>  tag_type;
+
+public:
+    //! The type of the `tagged_union` the view stands for
+    typedef tagged_union<Types...>  union_type;
+
+    //! Returns the index `stored_index` uses for type `T`.
+    template < typename T >
+    static constexpr
+    auto  index_of() noexcept -> std::size_t
+    { return mpl::index_of_v<T, Types...>::value; }
+    //! Returns the index used by `stored_index` for an empty record.
+    static constexpr
+    auto  empty_index() noexcept -> std::size_t
+    { return sizeof...( Types ); }
+
+    //! View the record starting at `first`, which must end by `last`
+    /** \throws  archive_error  if [`first`, `last`) is too short for the
+                 record, or its index is out of range.
+     */
+    tagged_union_view( unsigned char const *first, unsigned char const *last )
+        : first_{ first }, which_{ read_index(first, last) }
+    {
+        if ( static_cast<std::size_t>(last - first) < this->size() )
+            throw archive_error{ "archive is cut short" };
+    }
+    //! View the next record of `r`, and take its bytes
+    /** \throws  archive_error  if `r` is too short for the record, or its
+                 index is out of range.
+     */
+    explicit  tagged_union_view( binary_reader &r )
+        : tagged_union_view( r.peek(0u), r.peek(0u) + r.remaining() )
+    { r.take( this->size() ); }
+
+    //! Check the index of the type stored, `empty_index()` if none
+    auto  stored_index() const noexcept -> std::size_t  { return which_; }
+    //! Check the type of the object stored, NULL if none
+    auto  stored_type() const noexcept -> std::type_info const *
+    {
+        static std::type_info const * const  types[] = {
+            &typeid(Types)..., nullptr
+        };
+
+        return types[ which_ ];
+    }
+    //! The address of the stored member's bytes, NULL if none
+    auto  data() const noexcept -> unsigned char const *
+    { return ( which_ < sizeof...(Types) ) ? first_ + sizeof( tag_type ) :
+     nullptr; }
+    //! Check if the member's bytes are aligned for its type (false if empty)
+    bool  aligned() const noexcept
+    {
+        static std::size_t const  alignments[] = { alignof(Types)..., 0u };
+
+        return ( which_ < sizeof...(Types) ) && ( reinterpret_cast<
+         std::uintptr_t>(this->data()) % alignments[which_] == 0u );
+    }
+
+    //! The number of bytes in the record
+    auto  size() const noexcept -> std::size_t
+    {
+        static std::size_t const  sizes[] = { sizeof(Types)..., 0u };
+
+        return sizeof( tag_type ) + sizes[ which_ ];
+    }
+    //! The address just past the record, where the next one would start
+    auto  end() const noexcept -> unsigned char const *
+    { return first_ + this->size(); }
+
+private:
+    static  auto  read_index( unsigned char const *first, unsigned char const
+     *last ) -> std::size_t
+    {
+        tag_type  tag;
+
+        if ( static_cast<std::size_t>(last - first) < sizeof(tag) )
+            throw archive_error{ "archive is cut short" };
+        std::memcpy( &tag, first, sizeof(tag) );
+        if ( tag > sizeof...(Types) )
+            throw archive_error{ "archive has a bad union index" };
+        return tag;
+    }
+
+    // Member data
+    unsigned char const *  first_;  // the record's index
+    std::size_t            which_;  // its value
+};
+
+
+//  Tagged union view access function definitions  ---------------------------//
+
+//! Access the member of a `tagged_union_view`, in place
+/** \returns  A pointer to the member in the viewed bytes, if `v` isn't NULL,
+              stores a `T`, and the bytes are aligned for `T`.  NULL otherwise;
+              use the reference version, which copies, for unaligned members.
+ */
+template < typename T, typename ...Types >
+auto  gett( tagged_union_view<Types...> const *v ) noexcept -> T const *
+{
+    return ( v && (tagged_union_view<Types...>::template index_of<T>() !=
+     v->empty_index()) && (v->stored_index() == tagged_union_view<Types...>::
+     template index_of<T>()) && v->aligned() ) ? reinterpret_cast<T const *>(
+     v->data() ) : nullptr;
+}
+
+//! Copy out the member of a `tagged_union_view`
+/** \throws  boost::bad_get  if `v` doesn't store a `T`.
+
+    \returns  A copy of the member, whether or not its bytes are aligned.
+ */
+template < typename T, typename ...Types >
+auto  gett( tagged_union_view<Types...> const &v ) -> T
+{
+    if ( (tagged_union_view<Types...>::template index_of<T>() ==
+     v.empty_index()) || (v.stored_index() != tagged_union_view<Types...>::
+     template index_of<T>()) )
+        throw bad_get{};
+
+    typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+    std::memcpy( &b, v.data(), sizeof(T) );
+    return *reinterpret_cast<T const *>( &b );
+}
+
+//! \cond
+namespace detail
+{
+    // Calls "visitor" with the member, from the buffer if it's aligned, else
+    // from a copy on the stack
+    template < typename Result, typename T, typename Func >
+    auto  visit_viewed( Func &visitor, unsigned char const *data, bool aligned )
+      -> Result
+    {
+        if ( aligned )
+            return visitor( *reinterpret_cast<T const *>(data) );
+
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+        std::memcpy( &b, data, sizeof(T) );
+        return visitor( *reinterpret_cast<T const *>(&b) );
+    }
+}
+//! \endcond
+
+//! Call a function object with the member of a `tagged_union_view`
+/** The member is passed as `T const &`, referring to the viewed bytes when
+    they're aligned, and to a temporary copy otherwise.  The result type is
+    figured as for a `tagged_union<Types...> const &` passed to `visit`.
+
+    \throws  boost::bad_get  if `v` is empty.  Otherwise, anything `visitor`
+             throws.
+ */
+template < typename Func, typename ...Types >
+auto  visit( Func&& visitor, tagged_union_view<Types...> const &v )
+  -> typename detail::visit_result<Func, tagged_union<Types...> const &>::type
+{
+    typedef typename detail::visit_result<Func, tagged_union<Types...> const &
+     >::type  result_type;
+    typedef typename std::remove_reference<Func>::type  visitor_type;
+
+    static auto (* const  table[])( visitor_type &, unsigned char const *,
+     bool ) -> result_type = {
+        &detail::visit_viewed<result_type, Types, visitor_type>...
+    };
+
+    if ( v.stored_index() == v.empty_index() )
+        throw bad_get{};
+    return table[ v.stored_index() ]( visitor, v.data(), v.aligned() );
+}
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_TAGGED_UNION_VIEW_HPP
@@ -0,0 +1,654 @@
+//  Boost Unions Library, union_archive.hpp header file  ---------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Compact binary saving and loading of the library's unions.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the declarations and definitions of `binary_writer` and
+    `binary_reader`, which append bytes to and take bytes from a buffer; of
+    `member_codec`, a traits class giving how one variant type is written and
+    read; of `archive_error`, for input that can't be read; and of the `save`
+    and `load` functions for `tagged_union`, `super_union`, and `std::vector`s
+    of `tagged_union`.
+
+    A union is written as its index, in the smallest unsigned type that holds
+    every index, then its member as `member_codec` writes it.  The index
+    comes from the type list, not from `std::type_info`, so it doesn't change
+    between compilers.  The bytes of the index and of bitwise members are in
+    the machine's own order and layout, so archives move between programs on
+    the same platform, not across byte orders.
+ */
+
+#ifndef BOOST_UNIONS_UNION_ARCHIVE_HPP
+#define BOOST_UNIONS_UNION_ARCHIVE_HPP
+
+#include "boost/unions/super_union.hpp"
+#include "boost/unions/tagged_union.hpp"
+#include "boost/utility/index_sequence11.hpp"
+#include <boost/integer.hpp>
+#include <boost/variant/get.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Archive exception class definition  --------------------------------------//
+
+//! Exception for archive input that is cut short or has a bad index
+class archive_error
+    : public std::runtime_error
+{
+public:
+    //! Construct with the given message
+    explicit  archive_error( char const *what )
+        : std::runtime_error{ what }
+    {}
+};
+
+
+//  Binary archive buffer class definitions  ---------------------------------//
+
+//! Appends bytes to the end of a `std::vector`
+class binary_writer
+{
+public:
+    //! The type of the buffer
+    typedef std::vector<unsigned char>  buffer_type;
+
+    //! Construct to append to `bytes`
+    explicit  binary_writer( buffer_type &bytes ) noexcept
+        : bytes_( bytes )
+    {}
+
+    //! Append a copy of `n` bytes from `p`
+    void  write( void const *p, std::size_t n )
+    {
+        unsigned char const * const  b = static_cast<unsigned char const *>(
+         p );
+
+        bytes_.insert( bytes_.end(), b, b + n );
+    }
+    //! Append `n` bytes, to be filled in through the returned pointer
+    /** The pointer is good until the next write.
+     */
+    auto  extend( std::size_t n ) -> unsigned char *
+    {
+        std::size_t const  old = bytes_.size();
+
+        bytes_.resize( old + n );
+        return bytes_.data() + old;
+    }
+
+    //! The buffer being written to
+    auto  bytes() const noexcept -> buffer_type &  { return bytes_; }
+
+private:
+    buffer_type &  bytes_;
+};
+
+//! Takes bytes, in order, from the front of a range
+class binary_reader
+{
+public:
+    //! Construct to read the bytes in [`first`, `last`)
+    binary_reader( unsigned char const *first, unsigned char const *last )
+     noexcept
+        : next_{ first }, last_{ last }
+    {}
+    //! Construct to read all of `bytes`
+    explicit  binary_reader( std::vector<unsigned char> const &bytes ) noexcept
+        : binary_reader( bytes.data(), bytes.data() + bytes.size() )
+    {}
+
+    //! Take the next `n` bytes
+    /** \throws  archive_error  if fewer than `n` bytes are left.
+
+        \returns  A pointer to the first of the bytes taken.
+     */
+    auto  take( std::size_t n ) -> unsigned char const *
+    {
+        unsigned char const * const  result = this->peek( n );
+
+        next_ += n;
+        return result;
+    }
+    //! Look at the next `n` bytes, without taking them
+    /** \throws  archive_error  if fewer than `n` bytes are left.
+     */
+    auto  peek( std::size_t n ) const -> unsigned char const *
+    {
+        if ( this->remaining() < n )
+            throw archive_error{ "archive is cut short" };
+        return next_;
+    }
+    //! Copy the next `n` bytes to `p`
+    /** \throws  archive_error  if fewer than `n` bytes are left.
+     */
+    void  read( void *p, std::size_t n )
+    { std::memcpy( p, this->take(n), n ); }
+
+    //! The number of bytes not yet taken
+    auto  remaining() const noexcept -> std::size_t
+    { return static_cast<std::size_t>( last_ - next_ ); }
+
+private:
+    unsigned char const *  next_;
+    unsigned char const *  last_;
+};
+
+
+//  Member codec traits class template definitions  --------------------------//
+
+//! Traits class: variant type -> how to write and read it
+/** A specialization has the static member functions `void save(binary_writer
+    &, T const &)` and `T load(binary_reader &)`, and may have a static
+    `constexpr bool bitwise`, true when `save` writes exactly the object's
+    `sizeof(T)` bytes and `load` copies them back.  (Ranges of unions whose
+    types are all bitwise are saved with one `memcpy` per element.)
+
+    There is no definition for types without a specialization, so saving or
+    loading a union with such a type doesn't compile.  Trivially copyable
+    types other than pointers and pointers-to-member, and `std::basic_string`s
+    of trivially copyable types, are provided for; specialize this for other
+    types.  An address means nothing to another process, so pointers need a
+    codec that says what they point to.  Trivially copyable class types that
+    hold pointers are copied as is; those need a specialization too.
+
+    \tparam T       The variant type, without cv-qualification.
+    \tparam Enable  For the provided partial specializations; leave it be.
+ */
+template < typename T, class Enable = void >
+struct member_codec;
+
+//! Specialization of `member_codec` for trivially copyable non-array types
+/** Pointers and pointers-to-member are left out; they need their own codec.
+ */
+template < typename T >
+struct member_codec< T, typename std::enable_if<
+ std::is_trivially_copyable<T>::value && !std::is_array<T>::value &&
+ !std::is_pointer<T>::value && !std::is_member_pointer<T>::value>::type >
+{
+    //! The object's bytes are copied as is
+    static constexpr  bool  bitwise = true;
+
+    //! Append the bytes of `x`
+    static  void  save( binary_writer &w, T const &x )
+    { w.write( std::addressof(x), sizeof(T) ); }
+    //! Take an object's bytes
+    static  auto  load( binary_reader &r ) -> T
+    {
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+        r.read( &b, sizeof(T) );
+        return *reinterpret_cast<T const *>( &b );
+    }
+};
+
+template < typename T >
+constexpr bool  member_codec< T, typename std::enable_if<
+ std::is_trivially_copyable<T>::value && !std::is_array<T>::value &&
+ !std::is_pointer<T>::value && !std::is_member_pointer<T>::value>::type
+ >::bitwise;
+
+//! Specialization of `member_codec` for strings of trivially copyable types
+/** The length is written as a `std::uint64_t`, then the characters.
+ */
+template < typename Char, class Traits, class Allocator >
+struct member_codec< std::basic_string<Char, Traits, Allocator>, typename
+ std::enable_if<std::is_trivially_copyable<Char>::value>::type >
+{
+    //! The string's type
+    typedef std::basic_string<Char, Traits, Allocator>  string_type;
+
+    //! Append the length and characters of `s`
+    static  void  save( binary_writer &w, string_type const &s )
+    {
+        std::uint64_t const  length = s.size();
+
+        w.write( &length, sizeof(length) );
+        w.write( s.data(), s.size() * sizeof(Char) );
+    }
+    //! Take a length, then that many characters
+    static  auto  load( binary_reader &r ) -> string_type
+    {
+        std::uint64_t  length;
+
+        r.read( &length, sizeof(length) );
+        if ( length > r.remaining() / sizeof(Char) )
+            throw archive_error{ "archive is cut short" };
+
+        string_type  result( static_cast<std::size_t>(length), Char{} );
+
+        r.read( &result[0], result.size() * sizeof(Char) );
+        return result;
+    }
+};
+
+
+//  Implementation details  --------------------------------------------------//
+
+//! \cond
+namespace detail
+{
+    // The type an index is written as, for a union of "Count" types.  The
+    // value "Count" itself marks an empty tagged_union.
+    template < std::size_t Count >
+    using archive_tag = typename boost::uint_value_t<Count>::least;
+
+    // Whether the codec is a copy of the object's bytes
+    template < typename T, class Enable = void >
+    struct bitwise_codec
+        : std::false_type
+    { };
+
+    template < typename T >
+    struct bitwise_codec< T, typename std::enable_if<member_codec<T>::bitwise
+     >::type >
+        : std::true_type
+    { };
+
+    template < typename ...T >
+    struct all_bitwise;
+
+    template < >
+    struct all_bitwise<>
+        : std::true_type
+    { };
+
+    template < typename Head, typename ...Tail >
+    struct all_bitwise<Head, Tail...>
+        : std::integral_constant<bool, bitwise_codec<Head>::value &&
+           all_bitwise<Tail...>::value>
+    { };
+
+    template < std::size_t Count >
+    void  save_tag( binary_writer &w, std::size_t index )
+    {
+        archive_tag<Count> const  tag = static_cast<archive_tag<Count>>(
+         index );
+
+        w.write( &tag, sizeof(tag) );
+    }
+    template < std::size_t Count >
+    auto  load_tag( binary_reader &r ) -> std::size_t
+    {
+        archive_tag<Count>  tag;
+
+        r.read( &tag, sizeof(tag) );
+        return tag;
+    }
+
+    // Per-type steps, for tables indexed by a stored index
+    template < typename T >
+    void  save_object( binary_writer &w, void const *object )
+    { member_codec<T>::save( w, *static_cast<T const *>(object) ); }
+
+    template < typename T, class Union >
+    void  load_object( binary_reader &r, Union &u )
+    { u.template emplace<T>( member_codec<T>::load(r) ); }
+
+    template < typename T, class Vector >
+    void  load_element( binary_reader &r, Vector &v )
+    { v.emplace_back( member_codec<T>::load(r) ); }
+
+    template < std::size_t Index, typename ...Types >
+    void  save_super( binary_writer &w, super_union<Types...> const &su )
+    {
+        typedef typename variant_element<Index, super_union<Types...>>::type
+          member_type;
+
+        member_codec<member_type>::save( w, unions::get<Index>(su) );
+    }
+
+    template < std::size_t Index, typename ...Types >
+    void  load_super( binary_reader &r, super_union<Types...> &su )
+    {
+        typedef typename variant_element<Index, super_union<Types...>>::type
+          member_type;
+
+        ::new ( static_cast<void *>(std::addressof( unions::get<Index>(su) )) )
+         member_type( member_codec<member_type>::load(r) );
+    }
+
+    template < typename ...Types, std::size_t ...Indices >
+    void  save_super_at( binary_writer &w, super_union<Types...> const &su,
+     std::size_t index, boost::index_sequence<Indices...> )
+    {
+        static void (* const  table[])( binary_writer &, super_union<Types...>
+         const & ) = { &save_super<Indices, Types...>... };
+
+        if ( index >= sizeof...(Types) )
+            throw std::out_of_range{ "super_union has no member at that "
+             "index" };
+        save_tag<sizeof...( Types )>( w, index );
+        table[ index ]( w, su );
+    }
+
+    template < typename ...Types, std::size_t ...Indices >
+    auto  load_super_at( binary_reader &r, super_union<Types...> &su,
+     boost::index_sequence<Indices...> ) -> std::size_t
+    {
+        static void (* const  table[])( binary_reader &, super_union<Types...>
+         & ) = { &load_super<Indices, Types...>... };
+
+        std::size_t const  index = load_tag<sizeof...( Types )>( r );
+
+        if ( index >= sizeof...(Types) )
+            throw archive_error{ "archive has a bad union index" };
+        table[ index ]( r, su );
+        return index;
+    }
+}
+//! \endcond
+
+
+//  Union archive function definitions  --------------------------------------//
+
+//! Write a `tagged_union`: its index, then its member
+/** An empty union is written as the index `sizeof...(Types)`, alone.
+
+    \throws  boost::bad_get  if `u` stores a pointer to itself, which has no
+             meaning outside this run.  Also, whatever the member's codec, or
+             the buffer's growth, throws.
+ */
+template < class Policy, typename ...Types >
+void  save( binary_writer &w, basic_tagged_union<Policy, Types...> const &u )
+{
+    static void (* const  table[])( binary_writer &, void const * ) = {
+        &detail::save_object<Types>...
+    };
+
+    if ( u.storing_pointer_to_self() )
+        throw bad_get{};
+    if ( u.stored_index() < sizeof...(Types) )
+    {
+        detail::save_tag<sizeof...( Types )>( w, u.stored_index() );
+        table[ u.stored_index() ]( w, u.data() );
+    }
+    else
+        detail::save_tag<sizeof...( Types )>( w, sizeof...(Types) );
+}
+
+//! Read a `tagged_union` written by `save`
+/** The member is built in `u` with `emplace`, so a failure after the member
+    is read leaves `u` as its policy says.
+
+    \throws  archive_error  if the input is cut short, or its index is out of
+             range.  Also, whatever the member's codec or `emplace` throws.
+ */
+template < class Policy, typename ...Types >
+void  load( binary_reader &r, basic_tagged_union<Policy, Types...> &u )
+{
+    typedef basic_tagged_union<Policy, Types...>  union_type;
+
+    static void (* const  table[])( binary_reader &, union_type & ) = {
+        &detail::load_object<Types, union_type>...
+    };
+
+    std::size_t const  index = detail::load_tag<sizeof...( Types )>( r );
+
+    if ( index < sizeof...(Types) )
+        table[ index ]( r, u );
+    else if ( index == sizeof...(Types) )
+        u = union_type{};
+    else
+        throw archive_error{ "archive has a bad union index" };
+}
+
+//! Write the member of a `super_union` at `index`: the index, then the member
+/** A `super_union` doesn't know which member is active, so the caller says.
+
+    \throws  std::out_of_range  if `index` isn't less than `sizeof...(Types)`.
+             Also, whatever the member's codec, or the buffer's growth,
+             throws.
+ */
+template < typename ...Types >
+void  save( binary_writer &w, super_union<Types...> const &su, std::size_t
+ index )
+{
+    detail::save_super_at( w, su, index, typename
+     boost::make_index_sequence<sizeof...( Types )>::type{} );
+}
+
+//! Read a `super_union` member written by `save`, building it in `su`
+/** The member is constructed over whatever `su` held, which isn't destroyed
+    first; end its lifetime beforehand if its type needs that.
+
+    \throws  archive_error  if the input is cut short, or its index is out of
+             range.  Also, whatever the member's codec throws.
+
+    \returns  The index of the member read, which is now the active one.
+ */
+template < typename ...Types >
+auto  load( binary_reader &r, super_union<Types...> &su ) -> std::size_t
+{
+    return detail::load_super_at( r, su, typename
+     boost::make_index_sequence<sizeof...( Types )>::type{} );
+}
+
+//! \cond
+namespace detail
+{
+    // The size of the largest type
+    template < typename ...T >
+    constexpr
+    auto  largest_size() noexcept -> std::size_t
+    { return max_of( sizeof(T)... ); }
+
+    // A trivially copyable object with all-zero bytes
+    template < typename T >
+    auto  zero_bits() noexcept -> T
+    {
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type  b;
+
+        std::memset( &b, 0, sizeof(b) );
+        return *reinterpret_cast<T const *>( &b );
+    }
+
+    // Whether a vector of the union can be copied to and from an archive as
+    // bytes: every codec is bitwise, and the union (so no member is boxed,
+    // and its storage can hold any member) is trivially copyable
+    template < class Union, typename ...Types >
+    struct bulk_copyable
+        : std::integral_constant<bool, all_bitwise<Types...>::value &&
+           std::is_trivially_copyable<Union>::value>
+    { };
+
+    // Each element, by the general codecs
+    template < class Union, class Allocator, typename ...Types >
+    void  save_elements( binary_writer &w, std::vector<Union, Allocator> const
+     &v, std::false_type )
+    {
+        for ( Union const &u : v )
+            unions::save( w, u );
+    }
+
+    template < class Union, class Allocator, typename ...Types >
+    void  load_element( binary_reader &r, std::vector<Union, Allocator> &v )
+    {
+        typedef std::vector<Union, Allocator>  vector_type;
+
+        static void (* const  table[])( binary_reader &, vector_type & ) = {
+            &load_element<Types, vector_type>...
+        };
+
+        std::size_t const  index = load_tag<sizeof...( Types )>( r );
+
+        if ( index < sizeof...(Types) )
+            table[ index ]( r, v );
+        else if ( index == sizeof...(Types) )
+            v.emplace_back();
+        else
+            throw archive_error{ "archive has a bad union index" };
+    }
+
+    template < class Union, class Allocator, typename ...Types >
+    void  load_elements( binary_reader &r, std::vector<Union, Allocator> &v,
+     std::size_t count, std::false_type )
+    {
+        while ( count-- )
+            load_element<Union, Allocator, Types...>( r, v );
+    }
+
+    // Each element as bytes.  Every copy is the size of the largest member,
+    // then the position moves by the real size, so there's no branch on the
+    // type to mispredict; the extra bytes are overwritten by the next element
+    // (or, at the end, dropped).
+    template < class Union, class Allocator, typename ...Types >
+    void  save_elements( binary_writer &w, std::vector<Union, Allocator> const
+     &v, std::true_type )
+    {
+        typedef archive_tag<sizeof...( Types )>  tag_type;
+
+        static std::size_t const       sizes[] = { sizeof(Types)..., 0u };
+        static constexpr  std::size_t  largest = largest_size<Types...>();
+
+        // Grown once, for the most the elements could take, then cut back
+        static unsigned char const  zeros[ largest ] = { };  // empty's copies
+        std::size_t const           old_size = w.bytes().size();
+        unsigned char * const       start = w.extend( v.size() * (sizeof(
+         tag_type ) + largest) );
+        unsigned char *             p = start;
+
+        for ( Union const &u : v )
+        {
+            if ( u.storing_pointer_to_self() )
+            {
+                w.bytes().resize( old_size );
+                throw bad_get{};
+            }
+
+            std::size_t const   index = ( u.stored_index() < sizeof...(Types) )
+             ? u.stored_index() : sizeof...( Types );
+            tag_type const      tag = static_cast<tag_type>( index );
+            void const * const  data = u.data();
+
+            std::memcpy( p, &tag, sizeof(tag) );
+            std::memcpy( p + sizeof(tag), data ? data : zeros, largest );
+            p += sizeof( tag ) + sizes[ index ];
+        }
+        w.bytes().resize( old_size + (p - start) );
+    }
+
+    // Each element as bytes, over a copy of a union of the right type.  The
+    // copies are the size of the largest member while there's that much input
+    // left; the elements near the end go one by one.
+    template < class Union, class Allocator, typename ...Types >
+    void  load_elements( binary_reader &r, std::vector<Union, Allocator> &v,
+     std::size_t count, std::true_type )
+    {
+        typedef archive_tag<sizeof...( Types )>  tag_type;
+
+        static std::size_t const       sizes[] = { sizeof(Types)..., 0u };
+        static constexpr  std::size_t  largest = largest_size<Types...>();
+        static Union const             prototypes[] = {
+            Union{ zero_bits<Types>() }..., Union{}
+        };
+        unsigned char                  scratch[ largest ];  // empty's copies
+
+        unsigned char const * const  start = r.peek( r.remaining() );
+        unsigned char const *        p = start;
+        unsigned char const * const  last = start + r.remaining();
+
+        for ( ; count && static_cast<std::size_t>(last - p) >= sizeof(
+         tag_type ) + largest ; --count )
+        {
+            tag_type  tag;
+
+            std::memcpy( &tag, p, sizeof(tag) );
+            if ( tag > sizeof...(Types) )
+            {
+                r.take( p - start );
+                throw archive_error{ "archive has a bad union index" };
+            }
+            v.push_back( prototypes[tag] );
+
+            void * const  data = v.back().data();
+
+            std::memcpy( data ? data : scratch, p + sizeof(tag), largest );
+            p += sizeof( tag ) + sizes[ tag ];
+        }
+        r.take( p - start );
+        load_elements<Union, Allocator, Types...>( r, v, count,
+         std::false_type{} );
+    }
+}
+//! \endcond
+
+//! Write a `std::vector` of `tagged_union`: the count, then each element
+/** The count is a `std::uint64_t`, and the elements follow as `save` writes
+    them one at a time.  When every member type's codec is bitwise and the
+    union is trivially copyable, the buffer is grown once and each element is
+    one fixed-size `memcpy`, with no branch on its type.
+
+    \throws  boost::bad_get  if an element stores a pointer to itself.  Also,
+             whatever a member's codec, or the buffer's growth, throws.
+ */
+template < class Policy, typename ...Types, class Allocator >
+void  save( binary_writer &w, std::vector<basic_tagged_union<Policy,
+ Types...>, Allocator> const &v )
+{
+    typedef basic_tagged_union<Policy, Types...>  union_type;
+
+    std::uint64_t const  count = v.size();
+
+    w.write( &count, sizeof(count) );
+    detail::save_elements<union_type, Allocator, Types...>( w, v,
+     detail::bulk_copyable<union_type, Types...>{} );
+}
+
+//! Read a `std::vector` of `tagged_union` written by `save`, replacing `v`
+/** Like saving, this is done with fixed-size copies when the types allow.
+
+    \throws  archive_error  if the input is cut short, or has a bad index.
+             Also, whatever a member's codec, or the vector's growth, throws.
+             The elements read before the failure are kept.
+ */
+template < class Policy, typename ...Types, class Allocator >
+void  load( binary_reader &r, std::vector<basic_tagged_union<Policy,
+ Types...>, Allocator> &v )
+{
+    typedef basic_tagged_union<Policy, Types...>  union_type;
+    typedef detail::archive_tag<sizeof...( Types )>  tag_type;
+
+    std::uint64_t  count;
+
+    r.read( &count, sizeof(count) );
+    if ( count > r.remaining() / sizeof(tag_type) )
+        throw archive_error{ "archive is cut short" };
+    v.clear();
+    v.reserve( static_cast<std::size_t>(count) );
+    detail::load_elements<union_type, Allocator, Types...>( r, v,
+     static_cast<std::size_t>(count), detail::bulk_copyable<union_type,
+     Types...>{} );
+}
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_UNION_ARCHIVE_HPP
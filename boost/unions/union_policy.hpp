@@ -0,0 +1,170 @@
+//  Boost Unions Library, union_policy.hpp header file  ----------------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+/** \file
+    \brief  Policy classes to adjust the layout and behavior of extended-union
+            types.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definitions of `union_policy`, a class template that carries
+    the layout, exception-safety, and storage options for `basic_tagged_union`,
+    the tag types for the exception-safety options, and type-aliases for common
+    choices.  It also
+    defines the `BOOST_UNIONS_CACHE_LINE_SIZE` configuration macro, the size in
+    bytes assumed for a cache line.
+ */
+
+#ifndef BOOST_UNIONS_UNION_POLICY_HPP
+#define BOOST_UNIONS_UNION_POLICY_HPP
+
+#include <cstddef>
+#include <memory>
+
+
+//  Configuration macros  ----------------------------------------------------//
+
+/** \def  BOOST_UNIONS_CACHE_LINE_SIZE
+    \brief  The number of bytes in a cache line of the target machine.
+
+    Define this before including any Unions header to change it.  The default,
+    64, is right for the common x86 and ARM processors.  It should be a power
+    of two.
+ */
+#ifndef BOOST_UNIONS_CACHE_LINE_SIZE
+#define BOOST_UNIONS_CACHE_LINE_SIZE  64
+#endif
+
+
+namespace boost
+{
+namespace unions
+{
+
+
+//  Assignment guarantee tag class definitions  ------------------------------//
+
+/** \defgroup  guarantees  Assignment guarantee tags
+
+    Changing the type stored in a union means destroying the old object and
+    constructing the new one in its place.  When that construction can throw,
+    the union's policy picks what's done to keep a valid state.  When it can't
+    throw, every policy just destroys and constructs.
+ */
+//@{
+//! Nothing is kept; if the construction throws, the union is left empty.
+struct basic_guarantee
+{ };
+
+//! The old object's bytes are set aside on the stack until the new object is
+//! built, then put back just long enough to destroy it.  This is the strong
+//! guarantee, as long as the types' objects can be moved as raw bytes (which
+//! is true of nearly all types that don't point into themselves).
+struct relocating_guarantee
+{ };
+
+//! The new object is built on the heap, then moved into place.  This is the
+//! strong guarantee without relocating any bytes, as long as the new type's
+//! move-constructor doesn't throw.  (If it can, `relocating_guarantee` is used
+//! instead.)
+struct strong_guarantee
+{ };
+
+//! The union has two buffers; the new object is built in the unused one, then
+//! the old object is destroyed.  This is the strong guarantee with no
+//! conditions, and an assigned-to union is never empty, but the union's size
+//! doubles.
+struct never_empty_guarantee
+{ };
+//@}
+
+
+//  Union policy class template definition  ----------------------------------//
+
+//! Layout and behavior options for a tracked union type
+/** Policy classes for `basic_tagged_union` need `std::size_t` static constant
+    members named `alignment` and `inline_limit`, and type members named
+    `guarantee` and `allocator_type`.  A union type will be aligned to at least
+    `alignment` bytes, and so its size will be padded to a multiple of it too.
+    Zero, or any value not more than the natural alignment, leaves the natural
+    alignment (the strictest of the variant types') in place.  The `guarantee`
+    is one of the \ref guarantees, and says how assignments that change the
+    stored type handle exceptions.
+
+    A variant type bigger than a non-zero `inline_limit` bytes is kept on the
+    heap, so only a pointer to it takes up room in the union.  Its objects are
+    allocated through `allocator_type`, rebound to the type.  A new allocator
+    is default-constructed for each allocation and deallocation, so it should
+    be stateless (or share its state between copies).  Zero keeps every type
+    in the union.
+
+    \tparam Alignment    The minimum alignment for the union.  Must be zero or
+                         a power of two.
+    \tparam Guarantee    The exception-safety scheme for changing types.
+    \tparam InlineLimit  The size of the largest type kept in the union, zero
+                         for no limit.
+    \tparam Allocator    The allocator for the types over `InlineLimit`.
+ */
+template < std::size_t Alignment = 0u, class Guarantee = relocating_guarantee,
+ std::size_t InlineLimit = 0u, class Allocator = std::allocator<unsigned char> >
+struct union_policy
+{
+    static_assert( !(Alignment & (Alignment - 1u)), "The alignment must be "
+     "zero or a power of two" );
+
+    //! The minimum alignment of the union, zero for natural
+    static constexpr std::size_t  alignment = Alignment;
+    //! The size of the largest variant type kept inline, zero for no limit
+    static constexpr std::size_t  inline_limit = InlineLimit;
+    //! How changes of the stored type handle exceptions
+    typedef Guarantee  guarantee;
+    //! How the variant types over `inline_limit` are allocated
+    typedef Allocator  allocator_type;
+};
+
+//! \cond
+template < std::size_t Alignment, class Guarantee, std::size_t InlineLimit,
+ class Allocator >
+constexpr std::size_t  union_policy<Alignment, Guarantee, InlineLimit,
+ Allocator>::alignment;
+template < std::size_t Alignment, class Guarantee, std::size_t InlineLimit,
+ class Allocator >
+constexpr std::size_t  union_policy<Alignment, Guarantee, InlineLimit,
+ Allocator>::inline_limit;
+//! \endcond
+
+//! Policy for the natural layout
+typedef union_policy<>  default_union_policy;
+
+//! Policy to give each union its own cache line(s)
+/** Elements of an array of unions with this policy can be written by
+    different threads without the cache lines bouncing between them (false
+    sharing).
+ */
+typedef union_policy<BOOST_UNIONS_CACHE_LINE_SIZE>  cache_line_union_policy;
+
+//! Policy to keep only the variant types of up to `InlineLimit` bytes inline
+/** The rest are boxed on the heap, through `Allocator`, so one rare large
+    type doesn't make every union as large as it is.
+ */
+template < std::size_t InlineLimit, class Allocator = std::allocator<unsigned
+ char> >
+using small_buffer_union_policy = union_policy<0u, relocating_guarantee,
+ InlineLimit, Allocator>;
+
+
+}  // namespace unions
+}  // namespace boost
+
+
+#endif  // BOOST_UNIONS_UNION_POLICY_HPP
@@ -21,7 +21,9 @@
     specializations for any extended-union types; the creators of those types,
     or interested users, are expected to write those.  There are partial
     specializations for cv-qualified extended-union types, so the users only
-    have to make specializations for thier directly-created types.
+    have to make specializations for thier directly-created types.  It also
+    has `in_place_type_t` and `in_place_index_t`, the tags that select the
+    constructors that build a variant object in place.
  */
 
 #ifndef BOOST_UNIONS_VARIANT_TRAITS_HPP
@@ -74,6 +76,36 @@ template < class VariantType >
 struct variant_size;  // undefined
 
 
+//  In-place construction tag definitions  -----------------------------------//
+
+//! Tag: construct the given variant type in place
+/** Passed as the first argument of a constructor of an extended-union type,
+    it selects the constructor that builds an object of type `T` directly in
+    the union, from the remaining arguments.
+
+    \tparam T  The variant type to be constructed.
+ */
+template < typename T >
+struct in_place_type_t
+{
+    explicit constexpr  in_place_type_t() noexcept = default;
+};
+
+//! Tag: construct the variant type at the given index in place
+/** Like `in_place_type_t`, but names the type by its (zero-based) index in the
+    list of variant types.  The two tags are equivalent: the type at `Index`
+    is what is built, and a type listed more than once is stored at its first
+    index either way, as the type-based access functions expect.
+
+    \tparam Index  The index of the variant type to be constructed.
+ */
+template < std::size_t Index >
+struct in_place_index_t
+{
+    explicit constexpr  in_place_index_t() noexcept = default;
+};
+
+
 //  Union metadata template partial specialization definitions  --------------//
 
 //! Specialize `variant_element` to propagate a union's cv-qualification.
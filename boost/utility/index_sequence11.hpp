@@ -0,0 +1,101 @@
+//  Boost Utility Library, index_sequence11.hpp header file  -----------------//
+
+//  Copyright 2012 Daryle Walker.
+//  Distributed under the Boost Software License, Version 1.0.  (See the
+//  accompanying file LICENSE_1_0.txt or a copy at
+//  <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/utility/> for the library's home page.
+
+/** \file
+    \brief  Compile-time lists of consecutive indices.
+
+    \author  Daryle Walker
+
+    \version  0.5
+
+    \copyright  Boost Software License, version 1.0
+
+    Contains the definitions of the `index_sequence` class template, which
+    carries a list of `std::size_t` values in its template parameters, and of
+    `make_index_sequence`, which generates the list 0 through N - 1.  A function
+    template taking an `index_sequence` object can deduce the list as a pack,
+    then expand it to index other packs (or tables).  The generator splits the
+    range in halves, so the template instantiation depth only grows with the
+    logarithm of N.
+ */
+
+#ifndef BOOST_UTILITY_INDEX_SEQUENCE11_HPP
+#define BOOST_UTILITY_INDEX_SEQUENCE11_HPP
+
+#include <cstddef>
+
+
+namespace boost
+{
+
+
+//  Index-list class template definition  ------------------------------------//
+
+//! A list of indices, carried as a type
+/** \tparam Indices  The list's values.  May be empty.
+ */
+template < std::size_t ...Indices >
+struct index_sequence
+{
+    typedef index_sequence  type;
+
+    //! Returns the length of the list.
+    static constexpr  auto  size() noexcept -> std::size_t
+    { return sizeof...( Indices ); }
+};
+
+
+//  Index-list generator meta-function definitions  --------------------------//
+
+//! \cond
+namespace detail
+{
+    template < class Left, class Right >
+    struct join_index_sequences;
+
+    template < std::size_t ...Left, std::size_t ...Right >
+    struct join_index_sequences< index_sequence<Left...>,
+     index_sequence<Right...> >
+        : index_sequence< Left..., (sizeof...(Left) + Right)... >
+    { };
+}
+//! \endcond
+
+//! Meta-function: length -> list of the indices 0 through `Length - 1`
+/** The result is that the class inherits from the appropriate
+    `index_sequence`, so objects can be passed to a function template expecting
+    that type.  The result is also available as an inner type-alias `type`.
+
+    \tparam Length  The number of indices to generate.
+ */
+template < std::size_t Length >
+struct make_index_sequence
+    : detail::join_index_sequences<
+          typename make_index_sequence<Length / 2u>::type,
+          typename make_index_sequence<Length - Length / 2u>::type
+      >::type
+{ };
+
+//! Specialize `make_index_sequence` for the empty base case.
+template < >
+struct make_index_sequence<0u>
+    : index_sequence<>
+{ };
+
+//! Specialize `make_index_sequence` for the single-index base case.
+template < >
+struct make_index_sequence<1u>
+    : index_sequence<0u>
+{ };
+
+
+}  // namespace boost
+
+
+#endif  // BOOST_UTILITY_INDEX_SEQUENCE11_HPP
@@ -0,0 +1,158 @@
+//  Boost Unions Library, tagged_union alignment benchmark program file  -----//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+#include "boost/unions/union_policy.hpp"  // for ...::cache_line_union_policy
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <memory>    // for std::align
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+#ifdef __AVX__
+#include <immintrin.h>  // for _mm256_load_ps, etc.
+#endif
+
+
+// A SIMD-sized vector, which needs its full alignment for aligned loads
+struct alignas( 32 ) vec8
+{
+    float  lanes[ 8 ];
+};
+
+typedef boost::unions::tagged_union<int, vec8>  vec_union;
+
+typedef std::chrono::steady_clock  clock_type;
+
+float volatile     fsink;
+unsigned volatile  usink;
+
+// Sum the vectors in each union; with AVX, each uses an aligned load, which
+// faults if the storage were only aligned to its size's natural boundary.
+double  time_vector_sum( vec_union const *u, std::size_t count, std::size_t
+ passes )
+{
+    auto const  start = clock_type::now();
+    float       total = 0.0f;
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+#ifdef __AVX__
+        __m256  acc = _mm256_setzero_ps();
+
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            acc = _mm256_add_ps( acc, _mm256_load_ps(
+             boost::unions::gett<vec8>(u[ i ]).lanes) );
+
+        float  lanes[ 8 ];
+
+        _mm256_storeu_ps( lanes, acc );
+        for ( float  f : lanes )
+            total += f;
+#else
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            for ( float  f : boost::unions::gett<vec8>(u[ i ]).lanes )
+                total += f;
+#endif
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    fsink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+unsigned const  max_threads = 16u;
+
+// Have each thread bump the integer in its own element of a union array.  The
+// array is on the stack, which (unlike C++11's operator new) keeps alignment.
+template < class Union >
+double  time_neighbor_writes( unsigned threads, std::size_t iterations )
+{
+    Union                     slots[ max_threads ];
+    std::vector<std::thread>  workers;
+
+    for ( auto &slot : slots )
+        slot = 0;
+
+    auto const  start = clock_type::now();
+
+    for ( unsigned  t = 0u ; t < threads ; ++t )
+        workers.emplace_back( [&slots, t, iterations]{
+            // Keep every write going to memory
+            int volatile &  counter = boost::unions::gett<int>( slots[t] );
+
+            for ( std::size_t  i = 0u ; i < iterations ; ++i )
+                counter = counter + 1;
+        } );
+    for ( auto &w : workers )
+        w.join();
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    usink = boost::unions::gett<int>( slots[threads - 1u] );
+    return elapsed.count() / iterations;
+}
+
+
+// Main program
+int  main()
+{
+    using boost::unions::basic_tagged_union;
+    using boost::unions::cache_line_union_policy;
+
+    std::size_t const  count = 4096u, passes = 2000u;
+
+    // Allocate by hand, since a C++11 allocator may not honor over-alignment.
+    std::vector<unsigned char>  raw( (count + 1u) * sizeof(vec_union) );
+    void *                      start = raw.data();
+    std::size_t                 space = raw.size();
+
+    vec_union *  unions = static_cast<vec_union *>( std::align(
+     alignof(vec_union), count * sizeof(vec_union), start, space) );
+
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        ::new ( unions + i ) vec_union{ vec8{{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f,
+         6.0f, 7.0f, 8.0f }} };
+
+    std::cout << "alignof(tagged_union<int, vec8>) = " << alignof( vec_union )
+              << ", sizeof = " << sizeof( vec_union ) << '\n'
+#ifdef __AVX__
+              << "Aligned AVX loads"
+#else
+              << "Scalar loads (no AVX)"
+#endif
+              << ", nanoseconds per union: " << std::fixed
+              << std::setprecision( 3 ) << time_vector_sum( unions, count,
+              passes ) << "\n\n";
+
+    typedef boost::unions::tagged_union<int>                  packed_union;
+    typedef basic_tagged_union<cache_line_union_policy, int>  padded_union;
+
+    unsigned const     cores = std::thread::hardware_concurrency();
+    unsigned const     threads = cores < 2u ? 2u : cores < max_threads ? cores
+                        : max_threads;
+    std::size_t const  iterations = 20000000u;
+
+    std::cout << "Neighboring writes from " << threads << " threads, "
+                 "nanoseconds per round\n" << std::setw( 24 ) << "policy"
+              << std::setw( 8 ) << "size" << std::setw( 12 ) << "time\n"
+              << std::setw( 24 ) << "default" << std::setw( 8 )
+              << sizeof( packed_union ) << std::setw( 12 )
+              << time_neighbor_writes<packed_union>( threads, iterations )
+              << '\n' << std::setw( 24 ) << "cache_line" << std::setw( 8 )
+              << sizeof( padded_union ) << std::setw( 12 )
+              << time_neighbor_writes<padded_union>( threads, iterations )
+              << '\n';
+    return 0;
+}
@@ -0,0 +1,111 @@
+//  Boost Unions Library, union archive benchmark program file  --------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/union_archive.hpp"  // for boost::unions::save, etc.
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <cstring>   // for std::memcpy
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937
+#include <vector>    // for std::vector
+
+
+// Telemetry samples of a few shapes
+struct reading  { std::uint64_t  sensor; double  value; };
+struct vector3  { float  x, y, z; };
+
+typedef boost::unions::tagged_union<int, double, reading, vector3>  sample;
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// Megabytes of archive per second for "passes" runs of "step"
+template < typename Step >
+double  rate( std::size_t bytes, std::size_t passes, Step step )
+{
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        step();
+
+    std::chrono::duration<double> const  elapsed = clock_type::now() - start;
+
+    return bytes * passes / elapsed.count() / 1.0e6;
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 20, passes = 20u;
+    std::mt19937       rng{ 2012u };
+    std::vector<sample>  v;
+
+    v.reserve( count );
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        switch ( rng() % 4u )
+        {
+        case 0u:  v.emplace_back( static_cast<int>(i) );  break;
+        case 1u:  v.emplace_back( 0.5 * i );  break;
+        case 2u:  v.emplace_back( reading{i, 0.25 * i} );  break;
+        default:  v.emplace_back( vector3{1.0f, 2.0f, 3.0f} );  break;
+        }
+
+    // The buffers are reused, so only the first pass pays for their memory
+    std::vector<unsigned char>  bytes, copy, b;
+
+    {
+        boost::unions::binary_writer  w{ bytes };
+
+        boost::unions::save( w, v );
+    }
+    copy.resize( bytes.size() );
+
+    std::vector<sample>  out;
+
+    std::cout << "Archiving " << count << " unions (" << bytes.size()
+              << " bytes vs. " << v.size() * sizeof( sample ) << " in memory),"
+              << " MB/s\n" << std::fixed << std::setprecision( 0 );
+    std::cout << std::setw( 22 ) << "memcpy" << std::setw( 10 ) << rate(
+     bytes.size(), passes, [&]{ std::memcpy(copy.data(), bytes.data(),
+     bytes.size()); sink = copy[ 7 ]; } ) << '\n';
+    std::cout << std::setw( 22 ) << "vector copy" << std::setw( 10 ) << rate(
+     bytes.size(), passes, [&]{ out.assign(v.begin(), v.end());
+     sink = out.size(); } ) << '\n';
+    std::cout << std::setw( 22 ) << "save, one at a time" << std::setw( 10 )
+              << rate( bytes.size(), passes, [&]{
+        boost::unions::binary_writer  w{ b };
+        std::uint64_t const           n = v.size();
+
+        b.clear();
+        w.write( &n, sizeof(n) );
+        for ( sample const &s : v )
+            boost::unions::save( w, s );
+        sink = b[ 7 ];
+    } ) << '\n';
+    std::cout << std::setw( 22 ) << "save, whole vector" << std::setw( 10 )
+              << rate( bytes.size(), passes, [&]{
+        boost::unions::binary_writer  w{ b };
+
+        b.clear();
+        boost::unions::save( w, v );
+        sink = b[ 7 ];
+    } ) << '\n';
+    std::cout << std::setw( 22 ) << "load, whole vector" << std::setw( 10 )
+              << rate( bytes.size(), passes, [&]{
+        boost::unions::binary_reader  r{ bytes };
+
+        boost::unions::load( r, out );
+        sink = out.size();
+    } ) << '\n';
+    return 0;
+}
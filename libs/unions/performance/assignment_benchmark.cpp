@@ -0,0 +1,93 @@
+//  Boost Unions Library, tagged_union assignment benchmark program file  ----//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+#include "boost/unions/union_policy.hpp"  // for boost::unions::union_policy
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstring>   // for std::memcpy, memset
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+
+
+// Non-trivial payloads, one whose copy is known not to throw and one whose
+// copy might
+template < bool Nothrow >
+struct payload
+{
+    unsigned char  bytes[ 192 ];
+
+    explicit payload( unsigned char b )
+    { std::memset( bytes, b, sizeof bytes ); }
+    payload( payload const &that ) noexcept( Nothrow )
+    { std::memcpy( bytes, that.bytes, sizeof bytes ); }
+    ~payload()  {}
+
+    payload &  operator =( payload const & ) = default;
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Copy-assign back and forth between a payload and an int, so every
+// assignment changes the stored type
+template < class Guarantee, bool Nothrow >
+double  time_cross_assignment( std::size_t iterations )
+{
+    typedef boost::unions::basic_tagged_union<boost::unions::union_policy<0u,
+     Guarantee>, int, payload<Nothrow>>  union_type;
+
+    union_type const  p{ payload<Nothrow>{7u} }, i{ 3 };
+    union_type        target;
+    std::size_t       total = 0u;
+    auto const        start = clock_type::now();
+
+    for ( std::size_t  k = 0u ; k < iterations ; ++k )
+    {
+        target = p;
+        total += target.stored_index();
+        target = i;
+        total += target.stored_index();
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( 2u * iterations );
+}
+
+template < class Guarantee >
+void  report( char const *name, std::size_t iterations )
+{
+    std::cout << std::setw( 24 ) << name << std::setw( 16 )
+              << time_cross_assignment<Guarantee, true>( iterations )
+              << std::setw( 16 )
+              << time_cross_assignment<Guarantee, false>( iterations ) << '\n';
+}
+
+
+// Main program
+int  main()
+{
+    using namespace boost::unions;
+
+    std::size_t const  iterations = 4000000u;
+
+    std::cout << "Type-changing copy assignment, nanoseconds per assignment\n"
+              << std::setw( 24 ) << "guarantee" << std::setw( 16 )
+              << "nothrow copy" << std::setw( 16 ) << "throwing copy" << '\n'
+              << std::fixed << std::setprecision( 2 );
+    report<basic_guarantee>( "basic", iterations );
+    report<relocating_guarantee>( "relocating (default)", iterations );
+    report<strong_guarantee>( "strong (heap)", iterations );
+    report<never_empty_guarantee>( "never_empty (2 buffers)", iterations );
+    return 0;
+}
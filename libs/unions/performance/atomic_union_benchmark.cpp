@@ -0,0 +1,139 @@
+//  Boost Unions Library, atomic tagged union benchmark program file  --------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/atomic_tagged_union.hpp"  // for ...::atomic_tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <mutex>     // for std::mutex, std::lock_guard
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+
+// Job states, published by one thread and watched by others; the union of
+// the first three fits in a word, and with the fourth in two
+struct idle     { };
+struct running  { std::uint32_t  job; };
+struct stopped  { std::int32_t  code; };
+struct failed   { std::uint32_t  job; std::int32_t  code; };
+
+// A state with more to say, so the union needs more than two words
+struct progress  { std::uint32_t  job, done; double  rate; };
+
+template < typename ...Types >
+struct locked_union
+{
+    typedef boost::unions::tagged_union<Types...>  value_type;
+
+    auto  load() const -> value_type
+    {
+        std::lock_guard<std::mutex>  g{ m };
+
+        return u;
+    }
+    void  store( value_type const &v )
+    {
+        std::lock_guard<std::mutex>  g{ m };
+
+        u = v;
+    }
+
+    mutable std::mutex  m;
+    value_type          u;
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Nanoseconds per operation, with one thread storing "ops" times and
+// "readers" threads each loading "ops" times
+template < class Shared, typename Make >
+double  run( int readers, std::size_t ops, Make make )
+{
+    Shared                    s;
+    std::vector<std::thread>  threads;
+    auto const                start = clock_type::now();
+
+    threads.emplace_back( [&]{
+        for ( std::size_t  i = 0u ; i < ops ; ++i )
+            s.store( make(i) );
+    } );
+    for ( int  r = 0 ; r < readers ; ++r )
+        threads.emplace_back( [&]{
+            std::size_t  sum = 0u;
+
+            for ( std::size_t  i = 0u ; i < ops ; ++i )
+                sum += s.load().stored_index();
+            sink = sum;
+        } );
+    for ( std::thread &t : threads )
+        t.join();
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    return elapsed.count() / ( ops * (readers + 1) );
+}
+
+template < typename ...Types, typename Make >
+void  compare( char const *name, int readers, std::size_t ops, Make make )
+{
+    typedef boost::unions::atomic_tagged_union<Types...>  atomic_type;
+
+    std::cout << std::setw( 16 ) << name << std::setw( 8 ) << readers
+              << std::setw( 10 ) << run<atomic_type>( readers, ops, make )
+              << std::setw( 10 ) << run<locked_union<Types...>>( readers,
+               ops, make ) << '\n';
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  ops = 1u << 20;
+
+    std::cout << "One writer, some readers, ns per operation ("
+              << std::thread::hardware_concurrency() << " hardware threads)\n"
+              << std::setw( 16 ) << "state" << std::setw( 8 ) << "readers"
+              << std::setw( 10 ) << "atomic" << std::setw( 10 ) << "mutex"
+              << '\n' << std::fixed << std::setprecision( 1 );
+    for ( int  readers : {1, 3} )
+    {
+        compare<idle, running, stopped>( "word", readers, ops,
+         [](std::size_t i) -> boost::unions::tagged_union<idle, running,
+         stopped> {
+            switch ( i % 3u )
+            {
+            case 0u:  return idle{};
+            case 1u:  return running{ static_cast<std::uint32_t>(i) };
+            default:  return stopped{ -1 };
+            }
+        } );
+        compare<idle, running, stopped, failed>( "double word", readers,
+         ops, [](std::size_t i) -> boost::unions::tagged_union<idle, running,
+         stopped, failed> {
+            switch ( i % 3u )
+            {
+            case 0u:  return idle{};
+            case 1u:  return running{ static_cast<std::uint32_t>(i) };
+            default:  return failed{ static_cast<std::uint32_t>(i), -1 };
+            }
+        } );
+        compare<idle, progress>( "sequence lock", readers, ops,
+         [](std::size_t i) -> boost::unions::tagged_union<idle, progress> {
+            if ( i % 2u )
+                return progress{ static_cast<std::uint32_t>(i), 1u, 0.5 };
+            return idle{};
+        } );
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+//  Boost Unions Library, tagged_union conversion benchmark program file  ----//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::int64_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <string>    // for std::string
+#include <utility>   // for std::move
+#include <vector>    // for std::vector
+
+
+// One pipeline stage's messages, and the next stage's wider set
+typedef boost::unions::tagged_union<std::int64_t, double, std::string>  stage1;
+typedef boost::unions::tagged_union<bool, std::int64_t, float, double,
+ std::string>  stage2;
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Ways of handing a message to the next stage
+struct by_probing
+{
+    void  operator ()( stage2 &to, stage1 &&from ) const
+    {
+        using boost::unions::gett;
+
+        if ( auto const  p = gett<std::int64_t>(&from) )
+            to = *p;
+        else if ( auto const  p = gett<double>(&from) )
+            to = *p;
+        else if ( auto const  p = gett<std::string>(&from) )
+            to = std::move( *p );
+        else
+            to = stage2{};
+    }
+};
+
+struct by_conversion
+{
+    void  operator ()( stage2 &to, stage1 &&from ) const
+    { to = std::move( from ); }
+};
+
+template < typename Converter >
+double  time_hand_off( std::size_t count, std::size_t passes )
+{
+    Converter            convert;
+    std::vector<stage1>  in;
+    std::vector<stage2>  out( count );
+    std::size_t          total = 0u;
+    std::chrono::duration<double, std::nano>  elapsed{ 0 };
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+        in.clear();
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            switch ( i % 3u )
+            {
+            case 0u:  in.emplace_back( std::int64_t(i) );  break;
+            case 1u:  in.emplace_back( 0.5 * i );  break;
+            default:  in.emplace_back( std::string(32u, 'a' + i % 26u) );
+            }
+
+        auto const  start = clock_type::now();
+
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            convert( out[i], std::move(in[i]) );
+        elapsed += clock_type::now() - start;
+        total += out[ p % count ].stored_index();
+    }
+
+    sink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 14, passes = 200u;
+
+    std::cout << "Widening hand-off, nanoseconds per message\n" << std::fixed
+              << std::setprecision( 2 )
+              << std::setw( 20 ) << "probe with gett" << std::setw( 10 )
+              << time_hand_off<by_probing>( count, passes ) << '\n'
+              << std::setw( 20 ) << "convert" << std::setw( 10 )
+              << time_hand_off<by_conversion>( count, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,153 @@
+//  Boost Unions Library, tagged_union dispatch benchmark program file  ------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <new>       // for placement new
+#include <typeinfo>  // for std::type_info
+
+
+// Distinct alternatives, with copying the compiler can't see through
+template < std::size_t I >
+struct alt
+{
+    unsigned  value;
+
+    explicit alt( unsigned v ) : value( v )  {}
+    alt( alt const &that ) : value( that.value + 1u )  {}
+    ~alt()  {}
+};
+
+template < std::size_t N, typename ...T >
+struct make_union
+{
+    typedef typename make_union<N - 1u, alt<N - 1u>, T...>::type  type;
+};
+
+template < typename ...T >
+struct make_union<0u, T...>
+{
+    typedef boost::unions::tagged_union<T...>  type;
+};
+
+// The old way: compare the type-info object of each alternative in turn
+template < typename ...T >
+struct linear_copier;
+
+template < >
+struct linear_copier<>
+{
+    static  void  copy( std::type_info const &, void const *, void * )  {}
+};
+
+template < typename Head, typename ...Tail >
+struct linear_copier<Head, Tail...>
+{
+    static  void  copy( std::type_info const &type, void const *s, void *d )
+    {
+        if ( type == typeid(Head) )
+            ::new ( d ) Head( *static_cast<Head const *>(s) );
+        else
+            linear_copier<Tail...>::copy( type, s, d );
+    }
+};
+
+template < typename U >
+struct linear_copier_for;
+
+template < typename ...T >
+struct linear_copier_for< boost::unions::tagged_union<T...> >
+    : linear_copier<T...>
+{ };
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t const  iterations = 4000000u;
+unsigned volatile  sink;
+
+// Time copy-constructing (and destroying) a union holding alternative "I"
+template < std::size_t N, std::size_t I >
+double  time_union_copy()
+{
+    typedef typename make_union<N>::type  union_type;
+
+    union_type const  source{ alt<I>{1u} };
+    unsigned          total = 0u;
+    auto const        start = clock_type::now();
+
+    for ( std::size_t  i = 0u ; i < iterations ; ++i )
+    {
+        union_type const  copy{ source };
+
+        total += boost::unions::gett<alt<I>>( copy ).value;
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / iterations;
+}
+
+// Time the same copy with the old type-info comparison chain
+template < std::size_t N, std::size_t I >
+double  time_linear_copy()
+{
+    typedef typename make_union<N>::type  union_type;
+
+    union_type const  source{ alt<I>{1u} };
+    unsigned          total = 0u;
+    auto const        start = clock_type::now();
+
+    for ( std::size_t  i = 0u ; i < iterations ; ++i )
+    {
+        alignas( alt<I> ) unsigned char  buffer[ sizeof(alt<I>) ] = { };
+
+        linear_copier_for<union_type>::copy( *source.stored_type(),
+         source.data(), buffer );
+        total += reinterpret_cast<alt<I> *>( buffer )->value;
+        reinterpret_cast<alt<I> *>( buffer )->~alt();
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / iterations;
+}
+
+template < std::size_t N >
+void  report()
+{
+    std::cout << std::setw( 12 ) << N
+              << std::setw( 14 ) << time_union_copy<N, 0u>()
+              << std::setw( 14 ) << time_union_copy<N, N - 1u>()
+              << std::setw( 16 ) << time_linear_copy<N, N - 1u>() << '\n';
+}
+
+
+// Main program
+int  main()
+{
+    std::cout << "Copy-construct + destroy, nanoseconds per operation\n"
+              << std::setw( 12 ) << "alternatives" << std::setw( 14 )
+              << "table, first" << std::setw( 14 ) << "table, last"
+              << std::setw( 16 ) << "typeid, last" << '\n' << std::fixed
+              << std::setprecision( 2 );
+    report<2u>();
+    report<4u>();
+    report<8u>();
+    report<16u>();
+    report<32u>();
+    report<64u>();
+    return 0;
+}
@@ -0,0 +1,83 @@
+//  Boost Unions Library, tagged_union emplace benchmark program file  -------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstring>   // for std::memcpy
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+
+
+// A decoder's large message body, filled from the wire
+struct block
+{
+    unsigned char  bytes[ 4096 ];
+
+    block( unsigned char const *wire, std::size_t length )
+    { std::memcpy( bytes, wire, length ); }
+};
+
+typedef boost::unions::tagged_union<int, block>  message;
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Ways of getting a decoded block into a message
+struct by_temporary_union
+{
+    void  operator ()( message &m, unsigned char const *wire ) const
+    { m = message{ block{wire, sizeof(block)} }; }
+};
+
+struct by_emplace
+{
+    void  operator ()( message &m, unsigned char const *wire ) const
+    { m.emplace<block>( wire, sizeof(block) ); }
+};
+
+template < typename Decoder >
+double  time_decoding( std::size_t iterations )
+{
+    static unsigned char  wire[ sizeof(block) ];
+    Decoder               decode;
+    message               m{ 0 };
+    std::size_t           total = 0u;
+    auto const            start = clock_type::now();
+
+    for ( std::size_t  i = 0u ; i < iterations ; ++i )
+    {
+        wire[ i % sizeof(wire) ] = static_cast<unsigned char>( i );
+        decode( m, wire );
+        total += boost::unions::gett<block>( m ).bytes[ i % sizeof(wire) ];
+        m = 0;
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / iterations;
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  iterations = 1000000u;
+
+    std::cout << "Decoding a 4 KiB block into a message, nanoseconds each\n"
+              << std::fixed << std::setprecision( 1 )
+              << std::setw( 24 ) << "temporary union" << std::setw( 10 )
+              << time_decoding<by_temporary_union>( iterations ) << '\n'
+              << std::setw( 24 ) << "emplace" << std::setw( 10 )
+              << time_decoding<by_emplace>( iterations ) << '\n';
+    return 0;
+}
@@ -0,0 +1,102 @@
+//  Boost Unions Library, tagged_union move benchmark program file  ----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <string>    // for std::string
+#include <utility>   // for std::move
+#include <vector>    // for std::vector
+
+
+// A member type whose move might throw, which makes the whole union's might
+struct risky
+{
+    int  value;
+
+    risky( risky const & ) = default;
+    risky( risky &&that ) noexcept( false ) : value( that.value )  {}
+};
+
+typedef boost::unions::tagged_union<int, std::string>         nothrow_union;
+typedef boost::unions::tagged_union<int, std::string, risky>  throwing_union;
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Grow a vector one string at a time, with no reserve, so it reallocates
+template < class Union >
+double  time_growth( std::size_t count, std::size_t passes )
+{
+    std::string const  text( 64u, 'g' );
+    std::size_t        total = 0u;
+    auto const         start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+        std::vector<Union>  v;
+
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            v.emplace_back( text );
+        total += v.size();
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+// Hand a string over to unions that hold ints, by move
+double  time_cross_move( std::size_t count, std::size_t passes )
+{
+    std::string const           text( 64u, 'c' );
+    std::vector<nothrow_union>  sources, targets;
+    std::size_t                 total = 0u;
+    std::chrono::duration<double, std::nano>  elapsed{ 0 };
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+        sources.assign( count, nothrow_union{text} );
+        targets.assign( count, nothrow_union{0} );
+
+        auto const  start = clock_type::now();
+
+        for ( std::size_t  i = 0u ; i < count ; ++i )
+            targets[ i ] = std::move( sources[i] );
+        elapsed += clock_type::now() - start;
+        total += targets.back().stored_index();
+    }
+
+    sink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 14, passes = 100u;
+
+    std::cout << "Nanoseconds per element\n" << std::fixed
+              << std::setprecision( 2 )
+              << std::setw( 36 ) << "vector growth, noexcept move"
+              << std::setw( 10 )
+              << time_growth<nothrow_union>( count, passes ) << '\n'
+              << std::setw( 36 ) << "vector growth, throwing move"
+              << std::setw( 10 )
+              << time_growth<throwing_union>( count, passes ) << '\n'
+              << std::setw( 36 ) << "string moved over int"
+              << std::setw( 10 ) << time_cross_move( count, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,117 @@
+//  Boost Unions Library, NaN-boxing benchmark program file  -----------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/nan_boxed_union.hpp"  // for ...::nan_boxed_union
+#include "boost/unions/tagged_union.hpp"     // for ...::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::int32_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <vector>    // for std::vector
+
+
+// An interpreter's value type, both ways
+struct object;
+
+typedef boost::unions::tagged_union<double, std::int32_t, bool, object *>
+  tagged_value;
+typedef boost::unions::nan_boxed_union<double, std::int32_t, bool, object *>
+  boxed_value;
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// The interpreter's "add" instruction: integers stay integers, and anything
+// with a double becomes a double.
+template < class Value >
+Value  add( Value const &a, Value const &b )
+{
+    using boost::unions::gett;
+
+    std::size_t const  int_index = Value::template index_of<std::int32_t>();
+
+    if ( a.stored_index() == int_index && b.stored_index() == int_index )
+        return gett<std::int32_t>( a ) + gett<std::int32_t>( b );
+
+    double const  x = ( a.stored_index() == int_index ) ? gett<std::int32_t>(
+     a ) : gett<double>( a );
+    double const  y = ( b.stored_index() == int_index ) ? gett<std::int32_t>(
+     b ) : gett<double>( b );
+
+    return x + y;
+}
+
+template < class Value >
+double  to_double( Value const &v )
+{
+    using boost::unions::gett;
+
+    return ( v.stored_index() == Value::template index_of<std::int32_t>() ) ?
+     gett<std::int32_t>( v ) : gett<double>( v );
+}
+
+// Run a loop that pushes, adds, and pops on an operand stack
+template < class Value >
+double  time_arithmetic( std::size_t count, std::size_t passes )
+{
+    std::vector<Value>  constants, stack;
+
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        if ( i % 4u )
+            constants.push_back( Value{static_cast<std::int32_t>( i % 7u )} );
+        else
+            constants.push_back( Value{0.25 * static_cast<double>( i % 5u )} );
+    stack.reserve( 2u );
+
+    double      total = 0.0;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+        stack.push_back( Value{std::int32_t( 0 )} );
+        for ( Value const &c : constants )
+        {
+            stack.push_back( c );
+
+            Value const  rhs = stack.back();
+
+            stack.pop_back();
+            stack.back() = add( stack.back(), rhs );
+        }
+        total += to_double( stack.back() );
+        stack.pop_back();
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 16, passes = 400u;
+
+    std::cout << "Interpreter add loop, nanoseconds per instruction\n"
+              << std::setw( 16 ) << "layout" << std::setw( 8 ) << "size"
+              << std::setw( 12 ) << "time" << '\n' << std::fixed
+              << std::setprecision( 3 )
+              << std::setw( 16 ) << "tagged_union" << std::setw( 8 )
+              << sizeof( tagged_value ) << std::setw( 12 )
+              << time_arithmetic<tagged_value>( count, passes ) << '\n'
+              << std::setw( 16 ) << "nan_boxed_union" << std::setw( 8 )
+              << sizeof( boxed_value ) << std::setw( 12 )
+              << time_arithmetic<boxed_value>( count, passes ) << '\n';
+    return 0;
+}
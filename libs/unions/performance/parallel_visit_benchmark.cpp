@@ -0,0 +1,163 @@
+//  Boost Unions Library, parallel visitation benchmark program file  --------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/parallel_visit.hpp"  // for ...::parallel_visit_reduce
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint16_t, uint32_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937, uniform_int_distribution
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+
+// Samples from several sensors, as a large log might hold them
+struct temperature  { float  celsius; };
+struct pressure     { double  pascals; };
+struct count        { std::uint32_t  events; };
+struct fault        { std::uint16_t  code; };
+
+typedef boost::unions::tagged_union<temperature, pressure, count, fault>
+  sample;
+
+// Weighs each sample; the reduction adds up the weights
+struct weigh
+{
+    double  operator ()( temperature const &t ) const  { return t.celsius; }
+    double  operator ()( pressure const &p ) const  { return p.pascals * 1e-3; }
+    double  operator ()( count const &c ) const  { return c.events; }
+    double  operator ()( fault const &f ) const  { return -f.code; }
+};
+
+struct plus
+{
+    double  operator ()( double a, double b ) const  { return a + b; }
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+// The usual hand-rolled version: an equal slice per thread, each probed
+// element by element with "gett," and the partial sums in a shared array
+double  probe_slice( std::vector<sample> const &v, std::size_t first,
+ std::size_t last )
+{
+    using boost::unions::gett;
+
+    double  sum = 0.0;
+
+    for ( std::size_t  i = first ; i < last ; ++i )
+        if ( temperature const * const  t = gett<temperature>(&v[ i ]) )
+            sum += t->celsius;
+        else if ( pressure const * const  p = gett<pressure>(&v[ i ]) )
+            sum += p->pascals * 1e-3;
+        else if ( count const * const  c = gett<count>(&v[ i ]) )
+            sum += c->events;
+        else if ( fault const * const  f = gett<fault>(&v[ i ]) )
+            sum -= f->code;
+    return sum;
+}
+
+double  hand_rolled( std::vector<sample> const &v, std::size_t threads )
+{
+    std::vector<double>       partial( threads );
+    std::vector<std::thread>  helpers;
+    std::size_t const         slice = v.size() / threads;
+
+    for ( std::size_t  i = 1u ; i < threads ; ++i )
+        helpers.emplace_back( [&, i]{ partial[ i ] = probe_slice( v, i *
+         slice, i + 1u < threads ? (i + 1u) * slice : v.size() ); } );
+    partial[ 0 ] = probe_slice( v, 0u, threads > 1u ? slice : v.size() );
+    for ( std::thread &t : helpers )
+        t.join();
+
+    double  sum = 0.0;
+
+    for ( double  p : partial )
+        sum += p;
+    return sum;
+}
+
+double  library( std::vector<sample> const &v, std::size_t threads )
+{
+    return boost::unions::parallel_visit_reduce( v.begin(), v.end(), 0.0,
+     weigh{}, plus{}, threads );
+}
+
+double volatile  sink;
+
+// Milliseconds for a pass over "v," best of "passes"
+template < typename Pass >
+double  time_pass( Pass pass, std::vector<sample> const &v, std::size_t
+ threads, std::size_t passes )
+{
+    double  best = 1e300;
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+    {
+        auto const  start = clock_type::now();
+
+        sink = pass( v, threads );
+
+        std::chrono::duration<double, std::milli> const  elapsed =
+         clock_type::now() - start;
+
+        best = elapsed.count() < best ? elapsed.count() : best;
+    }
+    return best;
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const    size = std::size_t{ 1u } << 25, passes = 5u;
+    std::size_t const    hardware = std::thread::hardware_concurrency();
+    std::vector<sample>  v;
+
+    {
+        std::mt19937                             rng{ 2012u };
+        std::uniform_int_distribution<unsigned>  any( 0u, 3u );
+
+        v.reserve( size );
+        for ( std::size_t  i = 0u ; i < size ; ++i )
+            switch ( any(rng) )
+            {
+            case 0u:  v.emplace_back( temperature{20.5f} );  break;
+            case 1u:  v.emplace_back( pressure{101325.0} );  break;
+            case 2u:  v.emplace_back( count{static_cast<std::uint32_t>(i %
+                       100u)} );  break;
+            default:  v.emplace_back( fault{static_cast<std::uint16_t>(i %
+                       7u)} );  break;
+            }
+    }
+
+    std::cout << "Summing " << size << " samples of " << sizeof( sample )
+              << " bytes, best of " << passes << ", milliseconds ("
+              << hardware << " hardware threads)\n"
+              << std::setw( 8 ) << "threads" << std::setw( 14 ) << "hand-rolled"
+              << std::setw( 12 ) << "library" << std::setw( 12 ) << "speed-up"
+              << '\n' << std::fixed << std::setprecision( 1 );
+
+    double  one = 0.0;
+
+    // Doubling, but stopping at the hardware's count on the way; at least to
+    // 4, to show what oversubscribing costs
+    for ( std::size_t  t = 1u ; t <= hardware || t <= 4u ; t = ( t < hardware
+     && hardware < t * 2u ) ? hardware : t * 2u )
+    {
+        double const  h = time_pass( &hand_rolled, v, t, passes );
+        double const  l = time_pass( &library, v, t, passes );
+
+        one = ( t == 1u ) ? l : one;
+        std::cout << std::setw( 8 ) << t << std::setw( 14 ) << h << std::setw(
+         12 ) << l << std::setw( 11 ) << one / l << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+//  Boost Unions Library, tagged union queue benchmark program file  ---------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_queue.hpp"  // for ...::tagged_union_queue
+
+#include <atomic>    // for std::atomic
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <mutex>     // for std::mutex, std::lock_guard
+#include <queue>     // for std::queue
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+
+// Messages on an order bus
+struct new_order  { std::uint64_t  id; char  symbol[ 8 ]; double  price;
+                    int  quantity; };
+struct cancel     { std::uint64_t  id; };
+struct heartbeat  { };
+
+typedef boost::unions::tagged_union<new_order, cancel, heartbeat>  message;
+
+// Adds up what the consumers see
+struct summer
+{
+    std::uint64_t *  sum;
+
+    void  operator ()( new_order const &o ) const  { *sum += o.quantity; }
+    void  operator ()( cancel const &c ) const  { *sum += c.id; }
+    void  operator ()( heartbeat const & ) const  { ++*sum; }
+};
+
+// The lock-free queue, built and visited in place
+struct ring
+{
+    boost::unions::tagged_union_queue<message, 1024u>  q;
+
+    void  produce( std::uint64_t i )
+    {
+        while ( !this->try_produce(i) )
+            std::this_thread::yield();
+    }
+    bool  try_produce( std::uint64_t i )
+    {
+        switch ( i % 4u )
+        {
+        case 0u:
+        case 1u:
+            return q.try_emplace<new_order>( new_order{i, "ABC", 1.5,
+             static_cast<int>(i % 100u)} );
+        case 2u:  return q.try_emplace<cancel>( cancel{i} );
+        default:  return q.try_emplace<heartbeat>();
+        }
+    }
+    bool  consume( std::uint64_t &sum )  { return q.try_visit( summer{&sum} ); }
+};
+
+// The same with a mutex and a std::queue, built, then moved in and out
+struct locked
+{
+    std::mutex           m;
+    std::queue<message>  q;
+
+    void  produce( std::uint64_t i )
+    {
+        message  msg;
+
+        switch ( i % 4u )
+        {
+        case 0u:
+        case 1u:
+            msg = new_order{ i, "ABC", 1.5, static_cast<int>(i % 100u) };
+            break;
+        case 2u:  msg = cancel{ i };  break;
+        default:  msg = heartbeat{};  break;
+        }
+
+        std::lock_guard<std::mutex>  g{ m };
+
+        q.push( std::move(msg) );
+    }
+    bool  consume( std::uint64_t &sum )
+    {
+        message  msg;
+
+        {
+            std::lock_guard<std::mutex>  g{ m };
+
+            if ( q.empty() )
+                return false;
+            msg = std::move( q.front() );
+            q.pop();
+        }
+        boost::unions::visit( summer{&sum}, msg );
+        return true;
+    }
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::uint64_t volatile  sink;
+
+// Millions of messages per second through "Bus," with "threads" producers
+// and as many consumers
+template < class Bus >
+double  run( int threads, std::uint64_t count )
+{
+    static Bus                  bus;
+    std::atomic<int>            producing{ threads };
+    std::atomic<std::uint64_t>  consumed{ 0u };
+    std::vector<std::thread>    workers;
+    auto const                  start = clock_type::now();
+
+    for ( int  t = 0 ; t < threads ; ++t )
+        workers.emplace_back( [&, t]{
+            for ( std::uint64_t  i = t ; i < count ; i += threads )
+                bus.produce( i );
+            --producing;
+        } );
+    for ( int  t = 0 ; t < threads ; ++t )
+        workers.emplace_back( [&]{
+            std::uint64_t  sum = 0u, n = 0u;
+
+            // Once the producers are done, a miss means the end
+            for ( ;; )
+                if ( bus.consume(sum) )
+                    ++n;
+                else if ( producing )
+                    std::this_thread::yield();
+                else if ( bus.consume(sum) )
+                    ++n;
+                else
+                    break;
+            consumed += n;
+            sink = sum;
+        } );
+    for ( std::thread &w : workers )
+        w.join();
+
+    std::chrono::duration<double, std::micro> const  elapsed =
+     clock_type::now() - start;
+
+    return ( consumed == count ) ? count / elapsed.count() : 0.0;
+}
+
+
+// Main program
+int  main()
+{
+    std::uint64_t const  count = 1u << 21;
+
+    std::cout << "Passing " << count << " unions of " << sizeof( message )
+              << " bytes, millions per second ("
+              << std::thread::hardware_concurrency() << " hardware threads)\n"
+              << std::setw( 20 ) << "producers/consumers" << std::setw( 12 )
+              << "lock-free" << std::setw( 14 ) << "mutex + queue" << '\n'
+              << std::fixed << std::setprecision( 1 );
+    for ( int  threads : {1, 2, 4, 8} )
+    {
+        std::cout << std::setw( 20 ) << threads << std::setw( 12 )
+                  << run<ring>( threads, count );
+        std::cout << std::setw( 14 ) << run<locked>( threads, count ) << '\n';
+    }
+    return 0;
+}
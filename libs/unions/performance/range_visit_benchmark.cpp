@@ -0,0 +1,154 @@
+//  Boost Unions Library, range visitation benchmark program file  -----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"        // for ...::tagged_union, etc.
+#include "boost/utility/index_sequence11.hpp"  // for ...::make_index_sequence
+
+#include <algorithm>  // for std::stable_sort
+#include <chrono>     // for std::chrono::steady_clock, duration
+#include <cstddef>    // for std::size_t
+#include <iomanip>    // for std::setw
+#include <iostream>   // for std::cout
+#include <random>     // for std::mt19937, uniform_int_distribution
+#include <vector>     // for std::vector
+
+
+// Distinct alternatives, each handled by its own code
+template < std::size_t N >
+struct alternative
+{
+    double  value;
+};
+
+template < std::size_t ...N >
+auto  union_with( boost::index_sequence<N...> )
+  -> boost::unions::tagged_union<alternative<N>...>;
+
+template < std::size_t Count >
+using union_of = decltype( union_with(typename
+ boost::make_index_sequence<Count>::type{}) );
+
+struct accumulator
+{
+    double  sum;
+
+    template < std::size_t N >
+    void  operator ()( alternative<N> const &a )  { sum += a.value * (N + 1u); }
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// The ways to visit a whole range
+struct each_element
+{
+    template < typename Iterator >
+    void  operator ()( Iterator first, Iterator last, accumulator &a ) const
+    {
+        for ( ; first != last ; ++first )
+            boost::unions::visit( a, *first );
+    }
+};
+
+template < std::size_t Prefetch >
+struct by_bucket
+{
+    template < typename Iterator >
+    void  operator ()( Iterator first, Iterator last, accumulator &a ) const
+    { boost::unions::visit_range( first, last, a, Prefetch ); }
+};
+
+struct by_run
+{
+    template < typename Iterator >
+    void  operator ()( Iterator first, Iterator last, accumulator &a ) const
+    { boost::unions::visit_runs( first, last, a ); }
+};
+
+template < typename Visiter, typename Union >
+double  time_visits( std::vector<Union> const &v, std::size_t passes )
+{
+    Visiter      visit_all;
+    accumulator  a{ 0.0 };
+    auto const   start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        visit_all( v.begin(), v.end(), a );
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = a.sum;
+    return elapsed.count() / ( passes * v.size() );
+}
+
+// Fill with the given alternatives, as picked by "pick"
+template < typename Union, std::size_t ...N >
+void  fill( std::vector<Union> &v, std::vector<std::size_t> const &picks,
+ boost::index_sequence<N...> )
+{
+    Union const  choices[] = { Union{alternative<N>{ 0.5 * N }}... };
+
+    v.clear();
+    for ( std::size_t const  p : picks )
+        v.push_back( choices[p] );
+}
+
+template < std::size_t Count >
+void  report( char const *distribution, std::vector<std::size_t> const
+ &picks, std::size_t passes )
+{
+    typedef union_of<Count>  union_type;
+
+    std::vector<union_type>  v;
+
+    fill( v, picks, typename boost::make_index_sequence<Count>::type{} );
+    std::cout << std::setw( 6 ) << Count << std::setw( 10 ) << distribution
+              << std::setw( 10 ) << time_visits<each_element>( v, passes )
+              << std::setw( 10 ) << time_visits<by_bucket<0u>>( v, passes )
+              << std::setw( 10 ) << time_visits<by_bucket<16u>>( v, passes )
+              << std::setw( 10 ) << time_visits<by_run>( v, passes ) << '\n';
+}
+
+template < std::size_t Count >
+void  report_all( std::size_t size, std::size_t passes )
+{
+    std::mt19937                                rng{ 2012u };
+    std::uniform_int_distribution<std::size_t>  any( 0u, Count - 1u ),
+                                                percent( 0u, 99u );
+    std::vector<std::size_t>                    picks( size );
+
+    for ( std::size_t &p : picks )
+        p = any( rng );
+    report<Count>( "uniform", picks, passes );
+
+    for ( std::size_t &p : picks )
+        p = ( percent(rng) < 90u ) ? 0u : any( rng );
+    report<Count>( "90% one", picks, passes );
+
+    std::stable_sort( picks.begin(), picks.end() );
+    report<Count>( "sorted", picks, passes );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  size = 1u << 20, passes = 10u;
+
+    std::cout << "Visiting " << size << " elements, nanoseconds per element\n"
+              << std::setw( 6 ) << "types" << std::setw( 10 ) << "order"
+              << std::setw( 10 ) << "visit" << std::setw( 10 ) << "range"
+              << std::setw( 10 ) << "range+pf" << std::setw( 10 ) << "runs"
+              << '\n' << std::fixed << std::setprecision( 2 );
+    report_all<2u>( size, passes );
+    report_all<4u>( size, passes );
+    report_all<8u>( size, passes );
+    return 0;
+}
@@ -0,0 +1,279 @@
+//  Boost Unions Library, tagged union scheduler benchmark program file  -----//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_scheduler.hpp"  // for ...scheduler
+
+#include <atomic>      // for std::atomic
+#include <chrono>      // for std::chrono::steady_clock, duration
+#include <cstddef>     // for std::size_t
+#include <deque>       // for std::deque
+#include <functional>  // for std::function
+#include <iomanip>     // for std::setw
+#include <iostream>    // for std::cout
+#include <memory>      // for std::unique_ptr
+#include <mutex>       // for std::mutex, std::lock_guard
+#include <numeric>     // for std::accumulate, iota
+#include <thread>      // for std::thread
+#include <vector>      // for std::vector
+
+
+// Fork/join work, written once for both pools: a Fibonacci number by
+// splitting down to single calls, and a sum of a range by halving it down to
+// 1024 elements.  Each pool's worker gets a "spawn" for them, below.
+struct fib_task
+{
+    int                 n;
+    long *              result;
+    std::atomic<int> *  pending;
+
+    template < class Worker >
+    void  operator ()( Worker &w ) const;
+};
+
+struct sum_task
+{
+    int const *         first;
+    int const *         last;
+    long long *         result;
+    std::atomic<int> *  pending;
+
+    template < class Worker >
+    void  operator ()( Worker &w ) const;
+};
+
+bool  finished( std::atomic<int> const &pending )
+{ return !pending.load( std::memory_order_acquire ); }
+
+template < class Worker >
+void  fib_task::operator ()( Worker &w ) const
+{
+    if ( n < 2 )
+        *result = n;
+    else
+    {
+        long              a, b;
+        std::atomic<int>  children{ 2 };
+
+        spawn( w, fib_task{n - 1, &a, &children} );
+        spawn( w, fib_task{n - 2, &b, &children} );
+        w.help_until( [&]{ return finished(children); } );
+        *result = a + b;
+    }
+    pending->fetch_sub( 1, std::memory_order_release );
+}
+
+template < class Worker >
+void  sum_task::operator ()( Worker &w ) const
+{
+    if ( last - first <= 1024 )
+        *result = std::accumulate( first, last, 0LL );
+    else
+    {
+        int const * const  middle = first + ( last - first ) / 2;
+        long long          a, b;
+        std::atomic<int>   children{ 2 };
+
+        spawn( w, sum_task{first, middle, &a, &children} );
+        spawn( w, sum_task{middle, last, &b, &children} );
+        w.help_until( [&]{ return finished(children); } );
+        *result = a + b;
+    }
+    pending->fetch_sub( 1, std::memory_order_release );
+}
+
+// The scheduler under test, with tasks kept inline by type
+typedef boost::unions::tagged_union_scheduler<boost::unions::tagged_union<
+ fib_task, sum_task>>  union_pool;
+
+template < typename Task >
+void  spawn( union_pool::worker &w, Task const &task )
+{ w.template spawn<Task>( task ); }
+
+template < typename Task >
+void  submit( union_pool &pool, Task const &task )
+{ pool.template submit<Task>( task ); }
+
+// The common alternative: a work-stealing pool of type-erased closures, with
+// a locked deque per worker, the newest taken by its owner and the oldest
+// stolen by others
+class function_pool
+{
+public:
+    class worker;
+    typedef std::function<void( worker & )>  task_type;
+
+    class worker
+    {
+        friend class function_pool;
+
+    public:
+        void  spawn( task_type task )
+        {
+            std::lock_guard<std::mutex>  lock{ mutex_ };
+
+            tasks_.push_back( std::move(task) );
+        }
+        template < typename Predicate >
+        void  help_until( Predicate &&done )
+        {
+            while ( !done() )
+                if ( !this->run_one() )
+                    std::this_thread::yield();
+        }
+
+    private:
+        bool  take( task_type &task, bool newest )
+        {
+            std::lock_guard<std::mutex>  lock{ mutex_ };
+
+            if ( tasks_.empty() )
+                return false;
+            if ( newest )
+            {
+                task = std::move( tasks_.back() );
+                tasks_.pop_back();
+            }
+            else
+            {
+                task = std::move( tasks_.front() );
+                tasks_.pop_front();
+            }
+            return true;
+        }
+
+        bool  run_one()
+        {
+            std::size_t const  n = pool_->workers_.size();
+            task_type          task;
+            bool               found = this->take( task, true );
+
+            for ( std::size_t  i = 1u ; !found && i < n ; ++i )
+                found = pool_->workers_[ (index_ + i) % n ]->take( task,
+                 false );
+            if ( found )
+                task( *this );
+            return found;
+        }
+
+        function_pool *        pool_;
+        std::size_t            index_;
+        std::mutex             mutex_;
+        std::deque<task_type>  tasks_;
+    };
+
+    explicit  function_pool( std::size_t threads )
+        : stopping_{ false }
+    {
+        for ( std::size_t  i = 0u ; i < threads ; ++i )
+        {
+            workers_.emplace_back( new worker );
+            workers_.back()->pool_ = this;
+            workers_.back()->index_ = i;
+        }
+        for ( std::size_t  i = 0u ; i < threads ; ++i )
+            threads_.emplace_back( [this, i]{
+                while ( !stopping_ )
+                    if ( !workers_[i]->run_one() )
+                        std::this_thread::yield();
+            } );
+    }
+    ~function_pool()
+    {
+        stopping_ = true;
+        for ( std::thread &t : threads_ )
+            t.join();
+    }
+
+    void  submit( task_type task )
+    { workers_[ 0 ]->spawn( std::move(task) ); }
+
+private:
+    std::vector<std::unique_ptr<worker>>  workers_;
+    std::vector<std::thread>              threads_;
+    std::atomic<bool>                     stopping_;
+};
+
+// Each task becomes a closure, which std::function allocates for, since it
+// is bigger than the small-object buffer
+template < typename Task >
+void  spawn( function_pool::worker &w, Task const &task )
+{ w.spawn( [task]( function_pool::worker &w2 ){ task(w2); } ); }
+
+template < typename Task >
+void  submit( function_pool &pool, Task const &task )
+{ pool.submit( [task]( function_pool::worker &w ){ task(w); } ); }
+
+// Time "rounds" runs of "task," best of three, in milliseconds
+template < class Pool, typename Task >
+double  time_runs( Pool &pool, Task task, std::atomic<int> &pending, int
+ rounds )
+{
+    double  best = 1e300;
+
+    for ( int  r = 0 ; r < 3 ; ++r )
+    {
+        auto const  start = std::chrono::steady_clock::now();
+
+        for ( int  i = 0 ; i < rounds ; ++i )
+        {
+            pending = 1;
+            submit( pool, task );
+            while ( !finished(pending) )
+                std::this_thread::yield();
+        }
+
+        std::chrono::duration<double, std::milli> const  d =
+         std::chrono::steady_clock::now() - start;
+
+        best = d.count() < best ? d.count() : best;
+    }
+    return best;
+}
+
+
+int  main()
+{
+    long long const   n = 1LL << 24;
+    std::vector<int>  numbers( n );
+
+    std::iota( numbers.begin(), numbers.end(), 0 );
+    std::cout << "Fork/join, best of 3, milliseconds (tasks per run: fib 27, "
+     "~630k; sum 2^24 by 1024, ~32k)\n\n"
+     << std::setw( 8 ) << "workers" << std::setw( 14 ) << "fib union" <<
+     std::setw( 14 ) << "fib function" << std::setw( 14 ) << "sum union" <<
+     std::setw( 14 ) << "sum function" << '\n';
+    for ( std::size_t  threads : {1u, 2u, 4u} )
+    {
+        std::atomic<int>  pending{ 0 };
+        long              f = 0;
+        long long         s = 0;
+        fib_task const    fib{ 27, &f, &pending };
+        sum_task const    sum{ numbers.data(), numbers.data() +
+         numbers.size(), &s, &pending };
+        double            fu, ff, su, sf;
+
+        {
+            union_pool  pool{ threads };
+
+            fu = time_runs( pool, fib, pending, 2 );
+            su = time_runs( pool, sum, pending, 4 );
+        }
+        {
+            function_pool  pool{ threads };
+
+            ff = time_runs( pool, fib, pending, 2 );
+            sf = time_runs( pool, sum, pending, 4 );
+        }
+        std::cout << std::setw( 8 ) << threads << std::fixed <<
+         std::setprecision( 1 ) << std::setw( 14 ) << fu << std::setw( 14 ) <<
+         ff << std::setw( 14 ) << su << std::setw( 14 ) << sf << '\n';
+        if ( f != 196418L || s != n * (n - 1) / 2 )
+            std::cout << "wrong result\n";
+    }
+    return 0;
+}
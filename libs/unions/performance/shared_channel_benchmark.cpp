@@ -0,0 +1,152 @@
+//  Boost Unions Library, shared channel benchmark program file  -------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/shared_channel.hpp"  // for ...::tagged_union_channel
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <cstdlib>   // for std::_Exit
+#include <cstring>   // for std::memmove
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <new>       // for placement new
+
+#ifdef __linux__
+#include <sched.h>     // for sched_yield
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/wait.h>  // for waitpid
+#include <unistd.h>    // for fork, pipe, read, write, close
+#endif
+
+
+// Market data of a few shapes
+struct quote  { std::uint64_t  sequence; double  bid, ask; };
+struct trade  { std::uint64_t  sequence; double  price; int  size; };
+
+typedef boost::unions::tagged_union<int, quote, trade>  message;
+typedef boost::unions::tagged_union_channel<message, 4096u>  channel_type;
+
+typedef std::chrono::steady_clock  clock_type;
+
+message  make_message( std::uint64_t i )
+{
+    switch ( i % 3u )
+    {
+    case 0u:  return message{ static_cast<int>(i) };
+    case 1u:  return message{ quote{i, 1.0, 1.5} };
+    default:  return message{ trade{i, 1.25, 100} };
+    }
+}
+
+
+// Main program
+int  main()
+{
+#ifdef __linux__
+    std::uint64_t const  count = 1u << 22;
+
+    std::cout << "Passing " << count << " unions of " << sizeof( message )
+              << " bytes from a child process, ns per union\n" << std::fixed
+              << std::setprecision( 1 );
+
+    // Through the channel, read in place
+    {
+        void * const  p = mmap( nullptr, sizeof(channel_type), PROT_READ |
+         PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+
+        if ( p == MAP_FAILED )
+            return 1;
+
+        channel_type * const  c = ::new ( p ) channel_type;
+        auto const            start = clock_type::now();
+
+        if ( !fork() )
+        {
+            for ( std::uint64_t  i = 0u ; i < count ; ++i )
+                while ( !c->try_push(make_message( i )) )
+                    sched_yield();
+            std::_Exit( 0 );
+        }
+
+        std::size_t  sum = 0u;
+
+        for ( std::uint64_t  i = 0u ; i < count ; )
+            if ( message const * const  m = c->front() )
+            {
+                sum += m->stored_index();
+                c->pop();
+                ++i;
+            }
+            else
+                sched_yield();
+
+        std::chrono::duration<double, std::nano> const  elapsed =
+         clock_type::now() - start;
+
+        wait( nullptr );
+        std::cout << std::setw( 22 ) << "tagged_union_channel" << std::setw(
+         10 ) << elapsed.count() / count << "  (" << sum << ")\n";
+        munmap( p, sizeof(channel_type) );
+    }
+
+    // Through a pipe, a batch of unions per system call
+    {
+        std::size_t const  batch = 256u;
+        int                fds[ 2 ];
+
+        if ( pipe(fds) )
+            return 1;
+
+        auto const  start = clock_type::now();
+
+        if ( !fork() )
+        {
+            message  b[ batch ];
+
+            close( fds[0] );
+            for ( std::uint64_t  i = 0u ; i < count ; i += batch )
+            {
+                for ( std::size_t  j = 0u ; j < batch ; ++j )
+                    b[ j ] = make_message( i + j );
+                if ( write(fds[ 1 ], b, sizeof( b )) != sizeof(b) )
+                    std::_Exit( 1 );
+            }
+            std::_Exit( 0 );
+        }
+        close( fds[1] );
+
+        // A read may end partway through a union; the rest is kept for later
+        message       b[ batch ];
+        char * const  first = reinterpret_cast<char *>( b );
+        std::size_t   sum = 0u, received = 0u, kept = 0u;
+
+        for ( ssize_t  n ; (n = read( fds[0], first + kept, sizeof(b) - kept ))
+         > 0 ; )
+        {
+            std::size_t const  whole = ( kept + n ) / sizeof( message );
+
+            for ( std::size_t  j = 0u ; j < whole ; ++j )
+                sum += b[ j ].stored_index();
+            received += whole;
+            kept = ( kept + n ) % sizeof( message );
+            std::memmove( first, first + whole * sizeof(message), kept );
+        }
+
+        std::chrono::duration<double, std::nano> const  elapsed =
+         clock_type::now() - start;
+
+        wait( nullptr );
+        close( fds[0] );
+        std::cout << std::setw( 22 ) << "pipe, batches of 256" << std::setw(
+         10 ) << elapsed.count() / count << "  (" << sum << ", " << received
+                  << ")\n";
+    }
+#endif
+    return 0;
+}
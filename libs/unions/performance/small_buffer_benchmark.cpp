@@ -0,0 +1,80 @@
+//  Boost Unions Library, small-buffer tagged_union benchmark program file  --//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for ...::basic_tagged_union, etc.
+#include "boost/unions/union_policy.hpp"  // for ...::small_buffer_union_policy
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <vector>    // for std::vector
+
+
+// Market-data messages: two small, common ones and a rare book snapshot
+struct trade     { double  price, size; };
+struct quote     { double  bid, ask; };
+struct snapshot  { double  levels[ 128 ]; };
+
+typedef boost::unions::tagged_union<trade, quote, snapshot>  inline_message;
+typedef boost::unions::basic_tagged_union<
+ boost::unions::small_buffer_union_policy<16u>, trade, quote, snapshot>
+  boxed_message;
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// Fill with one snapshot per thousand messages, then sum the trade prices
+template < class Message >
+double  time_scan( std::size_t count, std::size_t passes )
+{
+    std::vector<Message>  v;
+
+    v.reserve( count );
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        if ( i % 1000u == 999u )
+            v.emplace_back( snapshot{} );
+        else if ( i % 2u )
+            v.emplace_back( quote{ 1.0, 1.5 } );
+        else
+            v.emplace_back( trade{ 0.5 * (i % 7u), 100.0 } );
+
+    double      total = 0.0;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        for ( Message const &m : v )
+            if ( auto const  t = boost::unions::gett<trade>(&m) )
+                total += t->price;
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( count * passes );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 17, passes = 20u;
+
+    std::cout << "Scanning " << count << " messages (1 in 1000 a "
+              << sizeof( snapshot ) << "-byte snapshot)\n" << std::fixed
+              << std::setprecision( 2 ) << std::setw( 20 ) << "" << std::setw(
+                 12 ) << "bytes each" << std::setw( 12 ) << "ns each" << '\n'
+              << std::setw( 20 ) << "all inline" << std::setw( 12 )
+              << sizeof( inline_message ) << std::setw( 12 )
+              << time_scan<inline_message>( count, passes ) << '\n'
+              << std::setw( 20 ) << "inline limit 16" << std::setw( 12 )
+              << sizeof( boxed_message ) << std::setw( 12 )
+              << time_scan<boxed_message>( count, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,143 @@
+//  Boost Unions Library, tagged union snapshot benchmark program file  ------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"           // for ...::tagged_union
+#include "boost/unions/tagged_union_snapshot.hpp"  // for tagged_union_snapshot
+
+#include <algorithm>  // for std::max
+#include <atomic>     // for std::atomic
+#include <chrono>     // for std::chrono::steady_clock, milliseconds
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint32_t
+#include <iomanip>    // for std::setw
+#include <iostream>   // for std::cout
+#include <mutex>      // for std::mutex, std::lock_guard
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+
+
+// Routing tables, one per address family
+struct route       { std::uint32_t  prefix, mask, next_hop, metric; };
+struct ipv4_table  { route  routes[ 64 ]; };
+struct ipv6_table  { route  routes[ 32 ]; std::uint32_t  scope; };
+
+typedef boost::unions::tagged_union<ipv4_table, ipv6_table>  routing;
+
+typedef std::chrono::steady_clock  clock_type;
+
+// What a reader looks up in a version
+std::uint32_t  lookup( routing const &r, std::uint32_t key )
+{
+    if ( ipv4_table const * const  t = boost::unions::gett<ipv4_table>(&r) )
+        return t->routes[ key % 64u ].next_hop;
+    return boost::unions::gett<ipv6_table>( &r )->routes[ key % 32u ].next_hop;
+}
+
+routing  make_routing( std::uint32_t v )
+{
+    if ( v % 2u )
+        return ipv6_table{ {{v, 0u, v, 1u}}, 0u };
+    return ipv4_table{ {{v, 0u, v, 1u}} };
+}
+
+// The same, behind a mutex, copied out by each reader
+struct locked_routing
+{
+    std::mutex  m;
+    routing     r{ make_routing(0u) };
+};
+
+// A reader of the snapshot, with its own handle
+struct snapshot_lookup
+{
+    boost::unions::tagged_union_snapshot<routing>::reader  r;
+
+    std::uint32_t  operator ()( std::uint32_t key ) const
+    { return lookup( *r.read(), key ); }
+};
+
+std::atomic<std::size_t>  sink{ 0u };
+
+// Reads per microsecond, over all "readers" threads, for "period", while one
+// more thread publishes a new version every millisecond
+template < typename Read, typename Write >
+double  run( int readers, std::chrono::milliseconds period, Read read, Write
+ write )
+{
+    std::atomic<bool>         done{ false };
+    std::atomic<std::size_t>  total{ 0u };
+    std::vector<std::thread>  threads;
+
+    for ( int  i = 0 ; i < readers ; ++i )
+        threads.emplace_back( [&]{
+            auto           reader = read();
+            std::size_t    n = 0u;
+            std::uint32_t  sum = 0u;
+
+            for ( ; !done.load(std::memory_order_relaxed) ; ++n )
+                sum += reader( static_cast<std::uint32_t>(n) );
+            total += n;
+            sink += sum;
+        } );
+    threads.emplace_back( [&]{
+        for ( std::uint32_t  v = 1u ; !done ; ++v )
+        {
+            write( v );
+            std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        }
+    } );
+    std::this_thread::sleep_for( period );
+    done = true;
+    for ( std::thread &t : threads )
+        t.join();
+    return total / std::chrono::duration<double, std::micro>( period ).count();
+}
+
+
+// Main program
+int  main()
+{
+    std::chrono::milliseconds const  period{ 300 };
+    int const  most = static_cast<int>( std::max(4u,
+     std::thread::hardware_concurrency()) );
+
+    std::cout << "Readers looking up a " << sizeof( routing ) << "-byte "
+              << "union, one write per ms, millions of reads per second ("
+              << std::thread::hardware_concurrency() << " hardware threads)\n"
+              << std::setw( 8 ) << "readers" << std::setw( 12 ) << "snapshot"
+              << std::setw( 14 ) << "mutex + copy" << '\n' << std::fixed
+              << std::setprecision( 1 );
+    for ( int  readers = 1 ; readers <= most ; readers *= 2 )
+    {
+        boost::unions::tagged_union_snapshot<routing>  cell{ make_routing(0u) };
+        locked_routing                                 locked;
+
+        std::cout << std::setw( 8 ) << readers << std::setw( 12 ) << run(
+         readers, period, [&]{
+            return snapshot_lookup{ cell.make_reader() };
+        }, [&]( std::uint32_t v ){ cell.store(make_routing( v )); } );
+        std::cout << std::setw( 14 ) << run( readers, period, [&]{
+            return [&locked]( std::uint32_t k ) {
+                routing  copy{ ipv4_table{} };
+
+                {
+                    std::lock_guard<std::mutex>  g{ locked.m };
+
+                    copy = locked.r;
+                }
+                return lookup( copy, k );
+            };
+        }, [&]( std::uint32_t v ){
+            routing const                next = make_routing( v );
+            std::lock_guard<std::mutex>  g{ locked.m };
+
+            locked.r = next;
+        } ) << '\n';
+    }
+    return 0;
+}
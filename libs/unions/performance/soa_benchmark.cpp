@@ -0,0 +1,104 @@
+//  Boost Unions Library, tagged_union_soa benchmark program file  -----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"      // for ...::tagged_union
+#include "boost/unions/tagged_union_soa.hpp"  // for ...::tagged_union_soa
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::int32_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <vector>    // for std::vector
+
+
+// An analytics event: a reading, a counter bump, or a bulky log record
+struct record
+{
+    std::int32_t  source;
+    char          text[ 44 ];
+};
+
+typedef boost::unions::tagged_union<double, std::int32_t, record>  event;
+typedef boost::unions::tagged_union_soa<double, std::int32_t, record>  events;
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// Sum the readings, over and over
+double  time_vector( std::vector<event> const &v, std::size_t passes )
+{
+    double      total = 0.0;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        for ( event const &e : v )
+            if ( auto const  x = boost::unions::gett<double>(&e) )
+                total += *x;
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( passes * v.size() );
+}
+
+double  time_soa( events const &s, std::size_t passes )
+{
+    double      total = 0.0;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        s.for_each<double>( [&total]( double x ){ total += x; } );
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( passes * s.size() );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 22, passes = 10u;
+
+    std::vector<event>  v;
+    events              s;
+
+    v.reserve( count );
+    s.reserve( count );
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        switch ( i % 4u )
+        {
+        case 0u:
+            v.emplace_back( 0.5 * (i % 100u) );
+            s.push_back( 0.5 * (i % 100u) );
+            break;
+        case 1u:
+            v.emplace_back( record{static_cast<std::int32_t>( i ), {}} );
+            s.push_back( record{static_cast<std::int32_t>( i ), {}} );
+            break;
+        default:
+            v.emplace_back( static_cast<std::int32_t>(i) );
+            s.push_back( static_cast<std::int32_t>(i) );
+            break;
+        }
+
+    std::cout << "Summing the doubles among " << count << " events, "
+              << "nanoseconds per event\n" << std::fixed
+              << std::setprecision( 3 )
+              << std::setw( 24 ) << "vector<tagged_union>" << std::setw( 10 )
+              << time_vector( v, passes ) << "  (" << sizeof( event )
+              << " bytes each)\n"
+              << std::setw( 24 ) << "tagged_union_soa" << std::setw( 10 )
+              << time_soa( s, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,103 @@
+//  Boost Unions Library, tagged_union swap benchmark program file  ----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <string>    // for std::string
+#include <utility>   // for std::move
+#include <vector>    // for std::vector
+
+
+typedef boost::unions::tagged_union<int, double, float *>  pod_union;
+typedef boost::unions::tagged_union<int, std::string>      string_union;
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// What std::swap did before the union had its own: three whole moves
+struct three_moves
+{
+    template < typename T >
+    void  operator ()( T &a, T &b ) const
+    {
+        T  temp{ std::move(a) };
+
+        a = std::move( b );
+        b = std::move( temp );
+    }
+};
+
+struct adl_swap
+{
+    template < typename T >
+    void  operator ()( T &a, T &b ) const
+    { swap( a, b ); }
+};
+
+// Reverse the array over and over, which is nothing but swaps
+template < typename Swapper, typename T >
+double  time_reversals( std::vector<T> &v, std::size_t passes )
+{
+    Swapper     swapper;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        for ( std::size_t  i = 0u, j = v.size() - 1u ; i < j ; ++i, --j )
+            swapper( v[i], v[j] );
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = v.front().stored_index();
+    return elapsed.count() / ( passes * (v.size() / 2u) );
+}
+
+template < typename T >
+void  report( char const *name, std::vector<T> &v, std::size_t passes )
+{
+    std::cout << std::setw( 28 ) << name
+              << std::setw( 14 ) << time_reversals<three_moves>( v, passes )
+              << std::setw( 14 ) << time_reversals<adl_swap>( v, passes )
+              << '\n';
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const  count = 1u << 14, passes = 400u;
+
+    std::vector<pod_union>     pods;
+    std::vector<string_union>  strings, mixed;
+
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+    {
+        if ( i % 2u )
+            pods.emplace_back( static_cast<int>(i) );
+        else
+            pods.emplace_back( 0.5 * i );
+        strings.emplace_back( std::string(40u, 'a' + i % 26u) );
+        if ( i % 3u )
+            mixed.emplace_back( std::string(40u, 'a' + i % 26u) );
+        else
+            mixed.emplace_back( static_cast<int>(i) );
+    }
+
+    std::cout << "Reversing arrays, nanoseconds per swap\n" << std::setw( 28 )
+              << "union" << std::setw( 14 ) << "three moves" << std::setw( 14 )
+              << "swap" << '\n' << std::fixed << std::setprecision( 2 );
+    report( "int/double/float* (bytes)", pods, passes );
+    report( "string/string (member swap)", strings, passes );
+    report( "int/string mix (either)", mixed, passes );
+    return 0;
+}
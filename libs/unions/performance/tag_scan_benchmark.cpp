@@ -0,0 +1,136 @@
+//  Boost Unions Library, tag scanning benchmark program file  ---------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tag_scan.hpp"  // for ...::count_alternative, etc.
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937, uniform_int_distribution
+#include <typeinfo>  // for typeid
+#include <vector>    // for std::vector
+
+
+// Market-data messages
+struct trade      { double  price, size; };
+struct quote      { double  bid, ask; };
+struct heartbeat  { long  sequence; };
+struct status     { int  code; };
+
+typedef boost::unions::tagged_union<trade, quote, heartbeat, status>  message;
+typedef boost::unions::tagged_union_soa<trade, quote, heartbeat, status>
+  messages;
+
+typedef std::chrono::steady_clock  clock_type;
+
+std::size_t volatile  sink;
+
+// Run "scan" over and over, reporting nanoseconds per element
+template < typename Scan >
+double  time_scan( Scan scan, std::size_t size, std::size_t passes )
+{
+    std::size_t  total = 0u;
+    auto const   start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        total += scan();
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = total;
+    return elapsed.count() / ( passes * size );
+}
+
+
+// Main program
+int  main()
+{
+    using boost::unions::count_alternative;
+    using boost::unions::find_alternative;
+    using boost::unions::mask_alternative;
+
+    std::size_t const  size = 1u << 20, passes = 50u;
+
+    std::mt19937                        rng{ 2012u };
+    std::uniform_int_distribution<int>  pick( 0, 9 );
+    std::vector<message>                v;
+    messages                            s;
+
+    // Mostly quotes and trades; the one status is last, for the finds
+    v.reserve( size );
+    for ( std::size_t  i = 1u ; i < size ; ++i )
+        switch ( pick(rng) )
+        {
+        case 0:   v.emplace_back( heartbeat{ long(i) } );  break;
+        case 1:
+        case 2:
+        case 3:   v.emplace_back( trade{ 1.0, 2.0 } );  break;
+        default:  v.emplace_back( quote{ 1.0, 2.0 } );  break;
+        }
+    v.emplace_back( status{ -1 } );
+    for ( message const &m : v )
+        s.push_back( m );
+
+    std::vector<std::uint64_t>  bits( (size + 63u) / 64u );
+
+    std::cout << "Scanning " << size << " messages, nanoseconds per message\n"
+              << std::fixed << std::setprecision( 3 )
+              << std::setw( 10 ) << "" << std::setw( 12 ) << "type_info"
+              << std::setw( 12 ) << "index" << std::setw( 12 ) << "soa tags"
+              << '\n';
+
+    std::cout << std::setw( 10 ) << "count" << std::setw( 12 ) << time_scan(
+     [&]{
+        std::size_t  n = 0u;
+
+        for ( message const &m : v )
+            n += ( *m.stored_type() == typeid(trade) );
+        return n;
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return count_alternative<trade>( v.begin(), v.end() );
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return count_alternative<trade>( s, 0u, s.size() );
+     }, size, passes ) << '\n';
+
+    std::cout << std::setw( 10 ) << "find last" << std::setw( 12 ) <<
+     time_scan( [&]{
+        std::size_t  i = 0u;
+
+        while ( i < v.size() && *v[i].stored_type() != typeid(status) )
+            ++i;
+        return i;
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return std::size_t( find_alternative<status>(v.begin(), v.end()) -
+         v.begin() );
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return find_alternative<status>( s );
+     }, size, passes ) << '\n';
+
+    std::cout << std::setw( 10 ) << "mask" << std::setw( 12 ) << time_scan(
+     [&]{
+        std::size_t  n = 0u;
+
+        for ( std::size_t  i = 0u ; i < v.size() ; ++i )
+            if ( *v[i].stored_type() == typeid(heartbeat) )
+            {
+                bits[ i / 64u ] |= std::uint64_t{ 1u } << ( i % 64u );
+                ++n;
+            }
+            else
+                bits[ i / 64u ] &= ~( std::uint64_t{1u} << (i % 64u) );
+        return n;
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return mask_alternative<heartbeat>( v.begin(), v.end(), bits.data() );
+     }, size, passes ) << std::setw( 12 ) << time_scan( [&]{
+        return mask_alternative<heartbeat>( s, bits.data() );
+     }, size, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,129 @@
+//  Boost Unions Library, tagged-union tree arena benchmark program file  ----//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/recursive_tagged_union.hpp"  // for ...::depth_first
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937
+
+
+// Expression trees, as a compiler front end would build and throw away
+struct expr;
+
+struct negate  { expr *operand; };
+struct binary  { char  op; expr *lhs, *rhs; };
+
+struct expr
+    : boost::unions::tagged_union<double, negate, binary>
+{
+    using basic_tagged_union::basic_tagged_union;
+};
+
+struct operands
+{
+    template < typename Push >
+    void  operator ()( negate const &n, Push const &push ) const
+    { push( n.operand ); }
+    template < typename Push >
+    void  operator ()( binary const &b, Push const &push ) const
+    {
+        push( b.lhs );
+        push( b.rhs );
+    }
+};
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// Node allocation: one heap block each, or the next slot of an arena
+struct from_heap
+{
+    template < typename T >
+    expr *  make( T &&x )  { return new expr( x ); }
+    void    free_tree( expr *e )
+    {
+        if ( auto const  n = boost::unions::gett<negate>(e) )
+            this->free_tree( n->operand );
+        else if ( auto const  b = boost::unions::gett<binary>(e) )
+        {
+            this->free_tree( b->lhs );
+            this->free_tree( b->rhs );
+        }
+        delete e;
+    }
+};
+
+struct from_arena
+{
+    boost::unions::tagged_union_arena<expr>  arena;
+
+    template < typename T >
+    expr *  make( T &&x )  { return arena.make( x ); }
+    void    free_tree( expr * )  { arena.clear(); }
+};
+
+// A random tree with "size" nodes, mostly binary
+template < class Allocator >
+expr *  build( Allocator &a, std::mt19937 &rng, std::size_t size )
+{
+    if ( size == 1u )
+        return a.make( 0.5 * (rng() % 16u) );
+    if ( size == 2u || rng() % 8u == 0u )
+        return a.make( negate{build( a, rng, size - 1u )} );
+
+    std::size_t const  left = 1u + rng() % ( size - 2u );
+
+    return a.make( binary{'+', build( a, rng, left ), build( a, rng, size - 1u
+     - left )} );
+}
+
+// Build, sum the leaves, and free a tree, many times over
+template < class Allocator >
+double  time_trees( std::size_t size, std::size_t trees )
+{
+    Allocator     a;
+    std::mt19937  rng{ 2012u };
+    double        sum = 0.0;
+    auto const    start = clock_type::now();
+
+    for ( std::size_t  t = 0u ; t < trees ; ++t )
+    {
+        expr * const  root = build( a, rng, size );
+
+        boost::unions::depth_first( *root, [&]( expr &e ){
+            if ( auto const  d = boost::unions::gett<double>(&e) )
+                sum += *d;
+        }, operands{} );
+        a.free_tree( root );
+    }
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = sum;
+    return elapsed.count() / ( trees * size );
+}
+
+
+// Main program
+int  main()
+{
+    std::cout << "Building, walking, and freeing expression trees, nanoseconds"
+              << " per node\n" << std::setw( 8 ) << "nodes" << std::setw( 10 )
+              << "new" << std::setw( 10 ) << "arena" << '\n' << std::fixed
+              << std::setprecision( 2 );
+    for ( std::size_t  size = 16u ; size <= 65536u ; size *= 16u )
+        std::cout << std::setw( 8 ) << size << std::setw( 10 ) <<
+         time_trees<from_heap>( size, (1u << 22) / size ) << std::setw( 10 ) <<
+         time_trees<from_arena>( size, (1u << 22) / size ) << '\n';
+    return 0;
+}
@@ -0,0 +1,140 @@
+//  Boost Unions Library, tagged_union_view benchmark program file  ----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_view.hpp"  // for ...::tagged_union_view
+
+#include <chrono>    // for std::chrono::steady_clock, duration
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937
+#include <vector>    // for std::vector
+
+
+// A replay log where one record in ten is the kind being looked for
+struct heartbeat  { std::uint64_t  time; };
+struct order      { std::uint64_t  id; double  price; int  size; };
+struct fill       { std::uint64_t  id; double  price, size; };
+
+typedef boost::unions::tagged_union<heartbeat, order, fill>  record;
+typedef boost::unions::tagged_union_view<heartbeat, order, fill>
+  record_view;
+
+typedef std::chrono::steady_clock  clock_type;
+
+double volatile  sink;
+
+// Sum the fill sizes in the log; the ways to read it
+struct by_loading
+{
+    double  operator ()( std::vector<unsigned char> const &log ) const
+    {
+        boost::unions::binary_reader  r{ log };
+        std::uint64_t                 count;
+        record                        u;
+        double                        sum = 0.0;
+
+        r.read( &count, sizeof(count) );
+        while ( count-- )
+        {
+            boost::unions::load( r, u );
+            if ( fill const * const  f = boost::unions::gett<fill>(&u) )
+                sum += f->size;
+        }
+        return sum;
+    }
+};
+
+struct by_loading_all
+{
+    double  operator ()( std::vector<unsigned char> const &log ) const
+    {
+        boost::unions::binary_reader  r{ log };
+        std::vector<record>           v;
+        double                        sum = 0.0;
+
+        boost::unions::load( r, v );
+        for ( record const &u : v )
+            if ( fill const * const  f = boost::unions::gett<fill>(&u) )
+                sum += f->size;
+        return sum;
+    }
+};
+
+struct by_viewing
+{
+    double  operator ()( std::vector<unsigned char> const &log ) const
+    {
+        boost::unions::binary_reader  r{ log };
+        std::uint64_t                 count;
+        double                        sum = 0.0;
+
+        r.read( &count, sizeof(count) );
+        while ( count-- )
+        {
+            record_view const  v{ r };
+
+            if ( v.stored_index() == record_view::index_of<fill>() )
+                sum += boost::unions::gett<fill>( v ).size;
+        }
+        return sum;
+    }
+};
+
+template < typename Reader >
+double  time_reads( std::vector<unsigned char> const &log, std::size_t count,
+ std::size_t passes )
+{
+    Reader      read;
+    double      sum = 0.0;
+    auto const  start = clock_type::now();
+
+    for ( std::size_t  p = 0u ; p < passes ; ++p )
+        sum += read( log );
+
+    std::chrono::duration<double, std::nano> const  elapsed =
+     clock_type::now() - start;
+
+    sink = sum;
+    return elapsed.count() / ( passes * count );
+}
+
+
+// Main program
+int  main()
+{
+    std::size_t const    count = 1u << 20, passes = 10u;
+    std::mt19937         rng{ 2012u };
+    std::vector<record>  records;
+
+    records.reserve( count );
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+        switch ( rng() % 10u )
+        {
+        case 0u:  records.emplace_back( fill{i, 1.5, 2.0} );  break;
+        case 1u:
+        case 2u:  records.emplace_back( heartbeat{i} );  break;
+        default:  records.emplace_back( order{i, 1.5, 3} );  break;
+        }
+
+    std::vector<unsigned char>    log;
+    boost::unions::binary_writer  w{ log };
+
+    boost::unions::save( w, records );
+    std::cout << "Replaying " << count << " records, one in ten wanted, "
+              << "nanoseconds per record\n" << std::fixed
+              << std::setprecision( 2 )
+              << std::setw( 16 ) << "load each" << std::setw( 10 )
+              << time_reads<by_loading>( log, count, passes ) << '\n'
+              << std::setw( 16 ) << "load vector" << std::setw( 10 )
+              << time_reads<by_loading_all>( log, count, passes ) << '\n'
+              << std::setw( 16 ) << "view" << std::setw( 10 )
+              << time_reads<by_viewing>( log, count, passes ) << '\n';
+    return 0;
+}
@@ -0,0 +1,193 @@
+//  Boost Unions Library, atomic_tagged_union run-time test file  ------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/atomic_tagged_union.hpp"  // for ...::atomic_tagged_union
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint16_t, etc.
+#include <thread>   // for std::thread
+#include <vector>   // for std::vector
+
+
+// A count kept as one of two types, by its parity, so a reader can tell if
+// the type and the member ever come from different writes
+template < typename Word >
+struct even
+{
+    Word  n;
+};
+
+template < typename Word >
+struct odd
+{
+    Word  n, check;
+};
+
+template < typename Word >
+using counter = boost::unions::tagged_union<even<Word>, odd<Word>>;
+
+template < typename Word >
+using atomic_counter = boost::unions::atomic_tagged_union<even<Word>,
+ odd<Word>>;
+
+using boost::unions::gett;
+
+template < typename Word >
+auto  make_counter( Word n ) -> counter<Word>
+{
+    if ( n % 2u )
+        return counter<Word>{ odd<Word>{n, static_cast<Word>( ~n )} };
+    return counter<Word>{ even<Word>{n} };
+}
+
+// The count, or -1 if "c" was torn
+template < typename Word >
+auto  read_counter( counter<Word> const &c ) -> long long
+{
+    if ( even<Word> const * const  e = gett<even<Word>>(&c) )
+        return ( e->n % 2u ) ? -1 : static_cast<long long>( e->n );
+    if ( odd<Word> const * const  o = gett<odd<Word>>(&c) )
+        return ( o->n % 2u && o->check == static_cast<Word>(~o->n) ) ?
+         static_cast<long long>( o->n ) : -1;
+    return -1;
+}
+
+
+// Each operation from one thread
+template < typename Word >
+void  test_operations()
+{
+    atomic_counter<Word>  a;
+
+    BOOST_TEST( a.load().stored_index() == a.load().empty_index() );
+    a.store( make_counter<Word>(3u) );
+    BOOST_TEST_EQ( read_counter(a.load()), 3 );
+    BOOST_TEST_EQ( read_counter(a.exchange( make_counter<Word>(4u) )), 3 );
+    BOOST_TEST_EQ( read_counter(a.load()), 4 );
+
+    counter<Word>  expected = make_counter<Word>( 5u );
+
+    BOOST_TEST( !a.compare_exchange(expected, make_counter<Word>( 6u )) );
+    BOOST_TEST_EQ( read_counter(expected), 4 );
+    BOOST_TEST( a.compare_exchange(expected, make_counter<Word>( 7u )) );
+    BOOST_TEST_EQ( read_counter(a.load()), 7 );
+
+    // The same count in the other type is different
+    expected = counter<Word>{ even<Word>{7u} };
+    BOOST_TEST( !a.compare_exchange(expected, counter<Word>{}) );
+    BOOST_TEST_EQ( read_counter(expected), 7 );
+
+    atomic_counter<Word>  b{ make_counter<Word>(1u) };
+
+    BOOST_TEST_EQ( read_counter(b.load()), 1 );
+
+    // Pointers-to-self mean nothing to other threads' copies
+    counter<Word> const  self{ &expected };
+
+    BOOST_TEST_THROWS( a.store(self), boost::bad_get );
+    BOOST_TEST_THROWS( a.exchange(self), boost::bad_get );
+    BOOST_TEST_EQ( read_counter(a.load()), 7 );
+}
+
+// Threads bump the count by compare-and-swap, switching its type each time,
+// while others read it; nothing may be torn and no bump may be lost
+template < typename Word >
+void  test_threads()
+{
+    int const                 bumpers = 3, readers = 2;
+    unsigned const            bumps = 20000u;
+    atomic_counter<Word>      a{ make_counter<Word>(0u) };
+    std::atomic<int>          bumpers_left{ bumpers };
+    std::atomic<std::size_t>  torn{ 0u }, reads{ 0u };
+    std::vector<std::thread>  threads;
+
+    for ( int  i = 0 ; i < bumpers ; ++i )
+        threads.emplace_back( [&]{
+            for ( unsigned  j = 0u ; j < bumps ; ++j )
+            {
+                counter<Word>  c = a.load();
+
+                while ( !a.compare_exchange(c, make_counter<Word>(
+                 static_cast<Word>(read_counter( c ) + 1))) )
+                    ;
+            }
+            --bumpers_left;
+        } );
+    for ( int  i = 0 ; i < readers ; ++i )
+        threads.emplace_back( [&]{
+            long long  last = 0;
+
+            do
+            {
+                long long const  n = read_counter( a.load() );
+
+                // Also, the count never goes backward
+                torn += ( n < last );
+                last = n;
+                ++reads;
+            } while ( bumpers_left );
+        } );
+    for ( std::thread &t : threads )
+        t.join();
+    BOOST_TEST_EQ( read_counter(a.load()), static_cast<long long>(bumpers) *
+     bumps );
+    BOOST_TEST_EQ( torn.load(), 0u );
+    BOOST_TEST( reads.load() > 0u );
+
+    // Plain stores and exchanges, checked only for tearing
+    threads.clear();
+    bumpers_left = bumpers;
+    for ( int  i = 0 ; i < bumpers ; ++i )
+        threads.emplace_back( [&, i]{
+            for ( unsigned  j = 0u ; j < bumps ; ++j )
+                if ( j % 2u )
+                    torn += read_counter( a.exchange(make_counter<Word>(
+                     static_cast<Word>( j * bumpers + i ))) ) < 0;
+                else
+                    a.store( make_counter<Word>(static_cast<Word>( j * bumpers
+                     + i )) );
+            --bumpers_left;
+        } );
+    for ( int  i = 0 ; i < readers ; ++i )
+        threads.emplace_back( [&]{
+            do
+                torn += read_counter( a.load() ) < 0;
+            while ( bumpers_left );
+        } );
+    for ( std::thread &t : threads )
+        t.join();
+    BOOST_TEST_EQ( torn.load(), 0u );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    // An image of 5 bytes is one word, and one of 17 needs the sequence lock;
+    // one of 9 uses a double-width CAS where that's available
+    static_assert( atomic_counter<std::uint16_t>::is_always_lock_free,
+     "Fits in a word" );
+    static_assert( !atomic_counter<std::uint64_t>::is_always_lock_free,
+     "Too big to be lock-free" );
+#ifdef BOOST_UNIONS_NO_WIDE_CAS
+    BOOST_TEST( !atomic_counter<std::uint32_t>::is_always_lock_free );
+#endif
+
+    test_operations<std::uint16_t>();
+    test_operations<std::uint32_t>();
+    test_operations<std::uint64_t>();
+
+    test_threads<std::uint16_t>();
+    test_threads<std::uint32_t>();
+    test_threads<std::uint64_t>();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,166 @@
+//  Boost Unions Library, nan_boxed_union run-time test file  ----------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/nan_boxed_union.hpp"  // for ...::nan_boxed_union
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstdint>      // for std::int32_t
+#include <limits>       // for std::numeric_limits
+#include <string>       // for std::string
+#include <type_traits>  // for std::is_arithmetic, enable_if, etc.
+#include <typeinfo>     // for std::type_info
+
+
+// An object type for the interpreter values to point to
+struct object
+{
+    int  id;
+};
+
+// The union we'll be working with...
+typedef boost::unions::nan_boxed_union<double, std::int32_t, bool, object *>
+  value_type;
+
+// ...And the access functions needed.
+using boost::unions::gett;
+using boost::unions::get;
+using boost::unions::visit;
+
+
+// The whole union is one word
+void  test_layout()
+{
+    static_assert( sizeof(value_type) == sizeof(double), "" );
+    static_assert( std::is_trivially_copyable<value_type>::value, "" );
+    static_assert( boost::unions::variant_size<value_type>::value == 4u, "" );
+    static_assert( std::is_same<boost::unions::variant_element<3u,
+     value_type>::type, object *>::value, "" );
+
+    BOOST_TEST_EQ( value_type::index_of<bool>(), 2u );
+    BOOST_TEST_EQ( value_type::index_of<value_type const *>(), 5u );
+    BOOST_TEST_EQ( value_type::index_of<float>(), value_type::empty_index() );
+    BOOST_TEST_EQ( value_type::variant_types().size(), 4u );
+}
+
+// Each kind of value goes in and comes back out unchanged
+void  test_round_trip()
+{
+    double const  inf = std::numeric_limits<double>::infinity();
+    object        o{ 5 };
+    value_type    d{ -2.5 }, i{ std::int32_t(-7) }, b{ true }, p{ &o }, e;
+
+    BOOST_TEST_EQ( d.stored_index(), 0u );
+    BOOST_TEST_EQ( i.stored_index(), 1u );
+    BOOST_TEST_EQ( b.stored_index(), 2u );
+    BOOST_TEST_EQ( p.stored_index(), 3u );
+    BOOST_TEST_EQ( e.stored_index(), value_type::empty_index() );
+    BOOST_TEST( *i.stored_type() == typeid(std::int32_t) );
+    BOOST_TEST( !e.stored_type() );
+    BOOST_TEST( !e.storing_pointer_to_self() );
+
+    BOOST_TEST_EQ( gett<double>(d), -2.5 );
+    BOOST_TEST_EQ( gett<std::int32_t>(i), -7 );
+    BOOST_TEST_EQ( get<2>(b), true );
+    BOOST_TEST_EQ( gett<object *>(p)->id, 5 );
+    BOOST_TEST_THROWS( gett<double>(i), boost::bad_get );
+    BOOST_TEST_THROWS( gett<bool>(e), boost::bad_get );
+    BOOST_TEST_THROWS( get<3>(d), boost::bad_get );
+
+    // The extremes of each range stay apart from the boxed words
+    value_type const  ni{ -inf }, pi{ inf }, big{ std::numeric_limits<
+     std::int32_t>::min() }, zero{ -0.0 }, null{ static_cast<object *>(
+     nullptr) };
+
+    BOOST_TEST_EQ( gett<double>(ni), -inf );
+    BOOST_TEST_EQ( gett<double>(pi), inf );
+    BOOST_TEST_EQ( gett<std::int32_t>(big), std::numeric_limits<std::int32_t>
+     ::min() );
+    BOOST_TEST_EQ( zero.stored_index(), 0u );
+    BOOST_TEST( !gett<object *>(null) );
+
+    // Every NaN is a double, including the negative ones
+    value_type const  qn{ std::numeric_limits<double>::quiet_NaN() },
+                      nn{ -std::numeric_limits<double>::quiet_NaN() };
+    double const      qd = gett<double>( qn ), nd = gett<double>( nn );
+
+    BOOST_TEST_EQ( nn.stored_index(), 0u );
+    BOOST_TEST( qd != qd );
+    BOOST_TEST( nd != nd );
+
+    i = 3.0;
+    BOOST_TEST_EQ( gett<double>(i), 3.0 );
+    i = false;
+    BOOST_TEST_EQ( gett<bool>(i), false );
+}
+
+// Pointers to self come after the listed types
+void  test_pointer_to_self()
+{
+    value_type        target{ std::int32_t(12) };
+    value_type const  link{ static_cast<value_type const *>(&target) };
+
+    BOOST_TEST( link.storing_pointer_to_self() );
+    BOOST_TEST( *link.stored_type() == typeid(value_type const *) );
+    BOOST_TEST_EQ( gett<std::int32_t>(*gett<value_type const *>(link)), 12 );
+    BOOST_TEST_THROWS( gett<value_type *>(link), boost::bad_get );
+}
+
+// Visitors for the visitation tests
+struct namer
+{
+    std::string  operator ()( double ) const  { return "double"; }
+    std::string  operator ()( std::int32_t ) const  { return "int"; }
+    template < typename T, typename = typename std::enable_if<
+     std::is_same<T, bool>::value>::type >
+    std::string  operator ()( T ) const  { return "bool"; }
+    std::string  operator ()( object * ) const  { return "object"; }
+};
+
+struct adder
+{
+    template < typename T, typename = typename std::enable_if<
+     std::is_arithmetic<T>::value>::type >
+    double  operator ()( T x ) const  { return x + 0.5; }
+
+    double  operator ()( object *o ) const  { return o->id; }
+
+    double  operator ()( value_type const *p ) const
+    { return visit( *this, *p ); }
+};
+
+// Visits are one indexed jump, with the value passed by value
+void  test_visit()
+{
+    object      o{ 9 };
+    value_type  d{ 1.5 }, i{ std::int32_t(4) }, b{ false }, p{ &o }, e;
+    value_type  s{ static_cast<value_type const *>(&i) };
+
+    BOOST_TEST_EQ( visit(namer{}, d), "double" );
+    BOOST_TEST_EQ( visit(namer{}, i), "int" );
+    BOOST_TEST_EQ( visit(namer{}, b), "bool" );
+    BOOST_TEST_EQ( visit(namer{}, p), "object" );
+    BOOST_TEST_THROWS( visit(namer{}, e), boost::bad_get );
+    BOOST_TEST_THROWS( visit(namer{}, s), boost::bad_get );
+
+    BOOST_TEST_EQ( visit(adder{}, d), 2.0 );
+    BOOST_TEST_EQ( visit(adder{}, p), 9.0 );
+    BOOST_TEST_EQ( visit(adder{}, s), 4.5 );
+}
+
+
+// Main program
+int  main()
+{
+    test_layout();
+    test_round_trip();
+    test_pointer_to_self();
+    test_visit();
+
+    return boost::report_errors();
+}
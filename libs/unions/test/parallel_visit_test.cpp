@@ -0,0 +1,169 @@
+//  Boost Unions Library, parallel_visit run-time test file  -----------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/parallel_visit.hpp"  // for ...::parallel_visit_reduce
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <climits>      // for LLONG_MIN
+#include <cstddef>      // for std::size_t
+#include <stdexcept>    // for std::runtime_error
+#include <vector>       // for std::vector
+
+
+typedef boost::unions::tagged_union<int, double, char>  element;
+
+// A mix of types, with some empties
+auto  make_range( std::size_t size ) -> std::vector<element>
+{
+    std::vector<element>  result;
+
+    result.reserve( size );
+    for ( std::size_t  i = 0u ; i < size ; ++i )
+        switch ( i % 7u )
+        {
+        case 0u:
+        case 3u:  result.emplace_back( static_cast<int>(i % 1000u) );  break;
+        case 1u:
+        case 5u:  result.emplace_back( static_cast<double>(i % 10u) );  break;
+        case 2u:  result.emplace_back( static_cast<char>('a' + i % 26u) );
+                  break;
+        default:  result.emplace_back();  break;
+        }
+    return result;
+}
+
+// Each type weighed differently, so a type mix-up shows
+struct weigh
+{
+    long long  operator ()( int i ) const  { return i; }
+    long long  operator ()( double d ) const
+    { return 10000 * static_cast<long long>( d ); }
+    long long  operator ()( char c ) const  { return 1000000 * c; }
+};
+
+struct plus
+{
+    long long  operator ()( long long a, long long b ) const  { return a + b; }
+};
+
+struct maximum
+{
+    long long  operator ()( long long a, long long b ) const
+    { return a < b ? b : a; }
+};
+
+// Counts only ints, without conversions
+struct ints_only
+{
+    long long  operator ()( int i ) const  { return i; }
+
+    template < typename T >
+    long long  operator ()( T const & ) const  { return 0; }
+};
+
+// Counts ints only, and fails on one value
+struct picky
+{
+    int  bad;
+
+    long long  operator ()( int i ) const
+    {
+        if ( i == bad )
+            throw std::runtime_error{ "bad element" };
+        return i;
+    }
+
+    template < typename T >
+    long long  operator ()( T const & ) const  { return 0; }
+};
+
+// Whether a char is a given letter; "bool" accumulators fold with "either"
+struct is_letter
+{
+    char  letter;
+
+    bool  operator ()( char c ) const  { return c == letter; }
+
+    template < typename T >
+    bool  operator ()( T const & ) const  { return false; }
+};
+
+struct either
+{
+    bool  operator ()( bool a, bool b ) const  { return a || b; }
+};
+
+using boost::unions::parallel_visit_reduce;
+using boost::unions::gett;
+
+
+// The same answers as a plain loop, whatever the size and thread count
+void  test_results( std::size_t size )
+{
+    std::vector<element> const  range = make_range( size );
+    long long                   sum = 0, most = LLONG_MIN, int_sum = 0;
+
+    for ( element const &e : range )
+    {
+        long long  w = 0;
+
+        if ( int const * const  i = gett<int>(&e) )
+            int_sum += w = *i;
+        else if ( double const * const  d = gett<double>(&e) )
+            w = weigh{}( *d );
+        else if ( char const * const  c = gett<char>(&e) )
+            w = weigh{}( *c );
+        else
+            continue;
+        sum += w;
+        most = w > most ? w : most;
+    }
+
+    for ( std::size_t  threads : {0u, 1u, 2u, 3u, 8u} )
+    {
+        BOOST_TEST_EQ( parallel_visit_reduce(range.begin(), range.end(), 0LL,
+         weigh{}, plus{}, threads), sum );
+        BOOST_TEST_EQ( parallel_visit_reduce(range.begin(), range.end(),
+         LLONG_MIN, weigh{}, maximum{}, threads), most );
+        BOOST_TEST_EQ( parallel_visit_reduce(range.begin(), range.end(), 0LL,
+         ints_only{}, plus{}, threads), int_sum );
+        BOOST_TEST_EQ( parallel_visit_reduce(range.begin(), range.end(),
+         false, is_letter{ 'c' }, either{}, threads), size > 2u );
+        BOOST_TEST( !parallel_visit_reduce(range.begin(), range.end(), false,
+         is_letter{ '!' }, either{}, threads) );
+    }
+}
+
+// The first exception comes out, and all the threads are joined
+void  test_exceptions()
+{
+    std::vector<element> const  range = make_range( 300000u );
+
+    for ( std::size_t  threads : {1u, 4u} )
+    {
+        BOOST_TEST_THROWS( parallel_visit_reduce(range.begin(), range.end(),
+         0LL, picky{ 500 }, plus{}, threads), std::runtime_error );
+        BOOST_TEST_EQ( parallel_visit_reduce(range.begin(), range.end(), 0LL,
+         picky{ -1 }, plus{}, threads), parallel_visit_reduce(range.begin(),
+         range.end(), 0LL, ints_only{}, plus{}, 1u) );
+    }
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    // Empty, within one chunk, and many chunks with a partial one at the end
+    test_results( 0u );
+    test_results( 5000u );
+    test_results( 250001u );
+    test_exceptions();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,144 @@
+//  Boost Unions Library, pointer_union run-time test file  ------------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/pointer_union.hpp"  // for boost::unions::pointer_union
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstdint>      // for std::uint64_t
+#include <type_traits>  // for std::is_trivially_copyable
+#include <typeinfo>     // for std::type_info
+
+
+// Node types for a small intrusive structure
+struct leaf;
+
+struct alignas( 8 ) branch
+{
+    int  weight;
+};
+
+struct alignas( 8 ) twig
+{
+    std::uint64_t  id;
+};
+
+// Incomplete where the union is declared, so its alignment is promised here
+namespace boost
+{
+namespace unions
+{
+    template < >
+    struct pointee_alignment<leaf>
+        : std::integral_constant<std::size_t, 16u>
+    { };
+}
+}
+
+// The unions we'll be working with...
+typedef boost::unions::pointer_union<branch *, twig const *, leaf *>
+  node_union;
+
+struct alignas( 16 ) leaf
+{
+    node_union  parent;
+};
+
+// ...And the access functions needed.
+using boost::unions::gett;
+using boost::unions::get;
+
+
+// The whole union is one word, with the tag in the alignment bits
+void  test_layout()
+{
+    static_assert( sizeof(node_union) == sizeof(void *), "" );
+    static_assert( std::is_trivially_copyable<node_union>::value, "" );
+    static_assert( boost::unions::variant_size<node_union>::value == 3u, "" );
+    static_assert( std::is_same<boost::unions::variant_element<1u,
+     node_union>::type, twig const *>::value, "" );
+
+    BOOST_TEST_EQ( node_union::tag_bits, 3u );
+    BOOST_TEST_EQ( node_union::index_of<leaf *>(), 2u );
+    BOOST_TEST_EQ( node_union::index_of<node_union const *>(), 4u );
+    BOOST_TEST_EQ( node_union::index_of<int *>(), node_union::empty_index() );
+    BOOST_TEST_EQ( node_union::variant_types().size(), 3u );
+}
+
+// Pointers come back out as stored, and the wrong type gives NULL or throws
+void  test_access()
+{
+    branch      b{ 7 };
+    twig const  t{ 42u };
+    leaf        l;
+    node_union  nb{ &b }, nt{ &t }, nl{ &l }, ne;
+
+    BOOST_TEST_EQ( nb.stored_index(), 0u );
+    BOOST_TEST_EQ( nt.stored_index(), 1u );
+    BOOST_TEST_EQ( nl.stored_index(), 2u );
+    BOOST_TEST_EQ( ne.stored_index(), node_union::empty_index() );
+    BOOST_TEST( *nt.stored_type() == typeid(twig const *) );
+    BOOST_TEST( !ne.stored_type() );
+    BOOST_TEST( !ne.data() );
+    BOOST_TEST( nb.data() == &b );
+
+    BOOST_TEST_EQ( gett<branch *>(nb), &b );
+    BOOST_TEST_EQ( gett<branch *>(nb)->weight, 7 );
+    BOOST_TEST_EQ( get<1>(nt)->id, 42u );
+    BOOST_TEST_EQ( gett<leaf *>(&nl), &l );
+    BOOST_TEST( !gett<branch *>(&nt) );
+    BOOST_TEST( !gett<leaf *>(&ne) );
+    BOOST_TEST( !get<0>(static_cast<node_union const *>( nullptr )) );
+    BOOST_TEST_THROWS( gett<twig const *>(nb), boost::bad_get );
+    BOOST_TEST_THROWS( get<2>(ne), boost::bad_get );
+
+    node_union const  nn{ static_cast<branch *>(nullptr) };
+
+    BOOST_TEST_EQ( nn.stored_index(), 0u );
+    BOOST_TEST( !gett<branch *>(nn) );
+    BOOST_TEST_THROWS( gett<leaf *>(nn), boost::bad_get );
+
+    nb = &l;
+    BOOST_TEST_EQ( gett<leaf *>(nb), &l );
+    nb = nt;
+    BOOST_TEST_EQ( gett<twig const *>(nb), &t );
+}
+
+// Pointers to self come after the listed types
+void  test_pointer_to_self()
+{
+    branch      b{ 3 };
+    node_union  target{ &b };
+    leaf        l;
+
+    l.parent = static_cast<node_union const *>( &target );
+    BOOST_TEST( l.parent.storing_pointer_to_self() );
+    BOOST_TEST( !target.storing_pointer_to_self() );
+    BOOST_TEST( !node_union{}.storing_pointer_to_self() );
+    BOOST_TEST( *l.parent.stored_type() == typeid(node_union const *) );
+    BOOST_TEST( !gett<node_union *>(&l.parent) );
+    BOOST_TEST_EQ( gett<branch *>(*gett<node_union const *>(l.parent))->weight,
+     3 );
+
+    node_union volatile  v;
+    node_union           s{ &v };
+
+    BOOST_TEST_EQ( gett<node_union volatile *>(s), &v );
+    BOOST_TEST_EQ( s.stored_index(), 5u );
+}
+
+
+// Main program
+int  main()
+{
+    test_layout();
+    test_access();
+    test_pointer_to_self();
+
+    return boost::report_errors();
+}
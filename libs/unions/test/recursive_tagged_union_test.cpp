@@ -0,0 +1,209 @@
+//  Boost Unions Library, recursive tagged-union run-time test file  ---------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/recursive_tagged_union.hpp"  // for ...::depth_first
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstddef>    // for std::size_t
+#include <stdexcept>  // for std::runtime_error
+#include <string>     // for std::string
+
+
+// An expression tree, with the node type declared ahead of its members
+struct expr;
+
+struct negate
+{
+    expr const *  operand;
+};
+
+struct binary
+{
+    char          op;
+    expr const *  lhs;
+    expr const *  rhs;
+};
+
+struct expr
+    : boost::unions::tagged_union<double, negate, binary>
+{
+    using basic_tagged_union::basic_tagged_union;
+
+    // For "visit," which takes only the union type itself
+    auto  as_union() const noexcept -> basic_tagged_union const &
+    { return *this; }
+};
+
+struct operands
+{
+    template < typename Push >
+    void  operator ()( negate const &n, Push const &push ) const
+    { push( n.operand ); }
+    template < typename Push >
+    void  operator ()( binary const &b, Push const &push ) const
+    {
+        push( b.lhs );
+        push( b.rhs );
+    }
+};
+
+// Writes the tree in prefix order
+struct prefix
+{
+    std::string &  out;
+
+    void  operator ()( double d ) const  { out += std::to_string( int(d) ); }
+    void  operator ()( negate const & ) const  { out += '~'; }
+    void  operator ()( binary const &b ) const  { out += b.op; }
+};
+
+// Counts destructor calls
+int  destroyed = 0;
+
+struct tracked
+{
+    int  value;
+
+    explicit  tracked( int v ) : value{ v }  {}
+    tracked( tracked const &that ) : value{ that.value }
+    {
+        if ( value < 0 )
+            throw std::runtime_error{ "negative" };
+    }
+    ~tracked()  { ++destroyed; }
+};
+
+
+// Build, walk, and reuse an arena of expression nodes
+void  test_expression_tree()
+{
+    boost::unions::tagged_union_arena<expr>  arena;
+
+    BOOST_TEST_EQ( arena.size(), 0u );
+    BOOST_TEST_EQ( arena.capacity(), 0u );
+
+    // (1 + 2) * ~3, with a null operand that gets skipped
+    expr const * const  one = arena.make( 1.0 );
+    expr const * const  sum = arena.make( binary{'+', one, arena.make(2.0)} );
+    expr const * const  neg = arena.make( negate{arena.make(3.0)} );
+    expr * const        root = arena.make( binary{'*', sum, neg} );
+    expr * const        odd = arena.make( negate{nullptr} );
+
+    BOOST_TEST_EQ( arena.size(), 7u );
+    BOOST_TEST_EQ( arena.capacity(), decltype(arena)::first_block );
+
+    // The links are to const nodes, so the walk is too
+    expr const &  croot = *root;
+    std::string   out;
+
+    boost::unions::depth_first( croot, [&]( expr const &e ){
+        boost::unions::visit( prefix{out}, e.as_union() ); }, operands{} );
+    BOOST_TEST_EQ( out, "*+12~3" );
+
+    // A node whose only link is null
+    std::size_t  count = 0u;
+
+    boost::unions::depth_first( static_cast<expr const &>(*odd), [&]( expr
+     const & ){ ++count; }, operands{} );
+    BOOST_TEST_EQ( count, 1u );
+
+    // Without a way to find children, there are none (the only pointers
+    // are to const nodes)
+    count = 0u;
+    boost::unions::depth_first( *root, [&]( expr & ){ ++count; } );
+    BOOST_TEST_EQ( count, 1u );
+
+    // Enough nodes for several blocks, then reuse them all
+    for ( int  i = 0 ; i < 1000 ; ++i )
+        arena.make( 1.0 * i );
+    BOOST_TEST_EQ( arena.size(), 1007u );
+
+    auto const  capacity = arena.capacity();
+
+    BOOST_TEST( capacity >= 1007u );
+    arena.clear();
+    BOOST_TEST_EQ( arena.size(), 0u );
+    for ( int  i = 0 ; i < 1007 ; ++i )
+        arena.make( 1.0 * i );
+    BOOST_TEST_EQ( arena.capacity(), capacity );
+}
+
+// Lists linked through pointers-to-self, deep enough to overflow the stack if
+// walked by recursion
+void  test_self_links()
+{
+    typedef boost::unions::tagged_union<int, std::string>  link;
+
+    boost::unions::tagged_union_arena<link>  arena;
+    link *                                   head = arena.make( 0 );
+
+    for ( int  i = 1 ; i < 200000 ; ++i )
+        head = arena.make( head );
+    BOOST_TEST( head->storing_pointer_to_self() );
+
+    std::size_t  count = 0u;
+    int          tail = -1;
+
+    boost::unions::depth_first( *head, [&]( link &l ){
+        ++count;
+        if ( auto const  p = boost::unions::gett<int>(&l) )
+            tail = *p;
+    } );
+    BOOST_TEST_EQ( count, 200000u );
+    BOOST_TEST_EQ( tail, 0 );
+
+    // Const nodes follow pointers-to-const-self too; empty nodes are leaves
+    link const * const  c = arena.make( static_cast<link const *>(head) );
+    link * const        e = arena.make();
+
+    count = 0u;
+    boost::unions::depth_first( *c, [&]( link const & ){ ++count; } );
+    BOOST_TEST_EQ( count, 200001u );
+    count = 0u;
+    boost::unions::depth_first( *e, [&]( link & ){ ++count; } );
+    BOOST_TEST_EQ( count, 1u );
+}
+
+// Every node is destroyed by "clear," or by the arena's destructor
+void  test_destruction()
+{
+    typedef boost::unions::tagged_union<tracked, int>  node;
+
+    destroyed = 0;
+    {
+        boost::unions::tagged_union_arena<node>  arena;
+
+        for ( int  i = 0 ; i < 100 ; ++i )
+            arena.make( tracked{i} );
+        destroyed = 0;
+        arena.clear();
+        BOOST_TEST_EQ( destroyed, 100 );
+
+        // A failed build leaves nothing behind
+        tracked const  bad{ -1 };
+
+        arena.make( tracked{1} );
+        arena.make( 2 );
+        BOOST_TEST_THROWS( arena.make(bad), std::runtime_error );
+        BOOST_TEST_EQ( arena.size(), 2u );
+        destroyed = 0;
+    }
+    BOOST_TEST_EQ( destroyed, 2 );  // "bad," then the arena's node
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_expression_tree();
+    test_self_links();
+    test_destruction();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,208 @@
+//  Boost Unions Library, shared_channel run-time test file  -----------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/shared_channel.hpp"  // for ...::tagged_union_channel
+#include "boost/unions/union_policy.hpp"    // for small_buffer_union_policy
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+#include <cstdlib>  // for std::_Exit
+#include <new>      // for placement new
+#include <string>   // for std::string
+
+#ifdef __linux__
+#include <sched.h>     // for sched_yield
+#include <stdlib.h>    // for mkstemp
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/wait.h>  // for waitpid
+#include <unistd.h>    // for fork, ftruncate, close, unlink
+#endif
+
+
+struct quote
+{
+    std::uint64_t  sequence;
+    double         price;
+};
+
+typedef boost::unions::tagged_union<int, double, quote>  message;
+
+using boost::unions::gett;
+using boost::unions::is_address_free;
+
+static_assert( is_address_free<message>::value, "Plain types are shared" );
+static_assert( !is_address_free<boost::unions::tagged_union<int, std::string>
+ >::value, "A string holds pointers" );
+static_assert( !is_address_free<boost::unions::tagged_union<int, char *>
+ >::value, "A pointer is an address" );
+static_assert( !is_address_free<boost::unions::tagged_union<int, double
+ quote::*> >::value, "So is a pointer-to-member" );
+static_assert( !is_address_free<boost::unions::basic_tagged_union<
+ boost::unions::small_buffer_union_policy<8u>, int, quote> >::value,
+ "A boxed member lives on one process's heap" );
+static_assert( !is_address_free<quote>::value, "Not a tagged_union" );
+
+// The message for the i-th value, cycling through the types
+message  make_message( std::uint64_t i )
+{
+    switch ( i % 4u )
+    {
+    case 0u:  return message{ static_cast<int>(i) };
+    case 1u:  return message{ 0.5 * i };
+    case 2u:  return message{ quote{i, 0.25 * i} };
+    default:  return message{};
+    }
+}
+
+// Whether "m" is what make_message gives for "i"
+bool  check_message( message const &m, std::uint64_t i )
+{
+    switch ( i % 4u )
+    {
+    case 0u:  return gett<int>( &m ) && *gett<int>( &m ) == static_cast<int>(
+     i );
+    case 1u:  return gett<double>( &m ) && *gett<double>( &m ) == 0.5 * i;
+    case 2u:  return gett<quote>( &m ) && gett<quote>( &m )->sequence == i;
+    default:  return m.stored_index() == m.empty_index();
+    }
+}
+
+
+// One side doing both ends, to check filling, draining, and wrapping
+void  test_one_side()
+{
+    typedef boost::unions::tagged_union_channel<message, 4u>  channel_type;
+
+    channel_type  c;
+    message       m;
+
+    BOOST_TEST_EQ( c.capacity(), 4u );
+    BOOST_TEST( c.empty() );
+    BOOST_TEST( !c.front() );
+    BOOST_TEST( !c.try_pop(m) );
+
+    std::uint64_t  pushed = 0u, popped = 0u;
+
+    for ( int  round = 0 ; round < 10 ; ++round )
+    {
+        while ( c.try_push(make_message( pushed )) )
+            ++pushed;
+        BOOST_TEST_EQ( c.size(), 4u );
+
+        // Half in place, half by copy
+        BOOST_TEST( c.front() && check_message(*c.front(), popped) );
+        c.pop();
+        ++popped;
+        BOOST_TEST( c.try_pop(m) && check_message(m, popped) );
+        ++popped;
+        BOOST_TEST_EQ( c.size(), 2u );
+    }
+    while ( c.try_pop(m) )
+        BOOST_TEST( check_message(m, popped++) );
+    BOOST_TEST_EQ( pushed, popped );
+    BOOST_TEST_EQ( pushed, 22u );
+    BOOST_TEST( c.empty() );
+
+    // Pointers-to-self aren't sent
+    message const  self{ &m };
+
+    BOOST_TEST_THROWS( c.try_push(self), boost::bad_get );
+    BOOST_TEST( c.empty() );
+}
+
+#ifdef __linux__
+// A child process produces into its own mapping of a shared file, which is at
+// a different address than the parent's, and the parent consumes
+void  test_two_processes()
+{
+    typedef boost::unions::tagged_union_channel<message, 256u>  channel_type;
+
+    std::uint64_t const  count = 100000u;
+    char                 name[] = "/tmp/shared_channel_testXXXXXX";
+    int const            fd = mkstemp( name );
+
+    BOOST_TEST( fd != -1 );
+    if ( fd == -1 )
+        return;
+    unlink( name );
+    BOOST_TEST_EQ( ftruncate(fd, sizeof( channel_type )), 0 );
+
+    void * const  here = mmap( nullptr, sizeof(channel_type), PROT_READ |
+     PROT_WRITE, MAP_SHARED, fd, 0 );
+
+    BOOST_TEST( here != MAP_FAILED );
+    if ( here == MAP_FAILED )
+        return;
+
+    channel_type * const  c = ::new ( here ) channel_type;
+    pid_t const           child = fork();
+
+    if ( !child )
+    {
+        // Map it again while the first mapping stays, so it must move
+        void * const  there = mmap( nullptr, sizeof(channel_type), PROT_READ |
+         PROT_WRITE, MAP_SHARED, fd, 0 );
+
+        if ( there == MAP_FAILED || there == here )
+            std::_Exit( 2 );
+
+        channel_type * const  d = static_cast<channel_type *>( there );
+
+        for ( std::uint64_t  i = 0u ; i < count ; ++i )
+            while ( !d->try_push(make_message( i )) )
+                sched_yield();
+        std::_Exit( 0 );
+    }
+    BOOST_TEST( child > 0 );
+    if ( child > 0 )
+    {
+        std::uint64_t  received = 0u, bad = 0u;
+        int            status = -1;
+        bool           exited = false;
+
+        // A child that quits or dies early stops the wait, once what it sent
+        // is drained, instead of hanging the test
+        while ( received < count )
+            if ( message const * const  m = c->front() )
+            {
+                bad += !check_message( *m, received++ );
+                c->pop();
+            }
+            else if ( exited )
+                break;
+            else
+            {
+                exited = ( waitpid(child, &status, WNOHANG) == child );
+                sched_yield();
+            }
+
+        if ( !exited )
+            BOOST_TEST_EQ( waitpid(child, &status, 0), child );
+        BOOST_TEST( WIFEXITED(status) && WEXITSTATUS(status) == 0 );
+        BOOST_TEST_EQ( received, count );
+        BOOST_TEST_EQ( bad, 0u );
+        BOOST_TEST( c->empty() );
+    }
+    munmap( here, sizeof(channel_type) );
+    close( fd );
+}
+#endif
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_one_side();
+#ifdef __linux__
+    test_two_processes();
+#endif
+
+    return boost::report_errors();
+}
@@ -0,0 +1,42 @@
+//  Boost Unions Library, tag_scan compile-time-fail test file  --------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tag_scan.hpp"  // for ...::count_alternative, etc.
+
+#include <cstdint>  // for std::uint64_t
+#include <vector>   // for std::vector
+
+
+// The containers we'll be working with...
+typedef boost::unions::tagged_union<int, double>      intdouble_t;
+typedef boost::unions::tagged_union_soa<int, double>  intdouble_soa_t;
+
+// ...And the scans needed.
+using boost::unions::count_alternative;
+using boost::unions::find_alternative;
+using boost::unions::mask_alternative;
+
+
+// Main program
+int  main()
+{
+    std::vector<intdouble_t>  v( 3u );
+    intdouble_soa_t           s;
+    std::uint64_t             bits[ 1 ];
+
+    // Each of these should fail
+    auto const  t1 = count_alternative<long>( s );
+    auto const  t2 = count_alternative<float>( s, 0u, 0u );
+    auto const  t3 = find_alternative<short>( s );
+    auto const  t4 = mask_alternative<char>( s, bits );
+    auto const  t5 = count_alternative<long>( v.begin(), v.end() );
+    auto const  t6 = find_alternative<intdouble_t *>( v.begin(), v.end() );
+    auto const  t7 = mask_alternative<char>( v.begin(), v.end(), bits );
+
+    return 0;
+}
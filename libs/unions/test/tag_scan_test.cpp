@@ -0,0 +1,168 @@
+//  Boost Unions Library, tag scanning run-time test file  -------------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tag_scan.hpp"  // for boost::unions::count_tag, etc.
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t, uint16_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+
+// Check each scan against a plain loop, for every start and length over a few
+// blocks, so the block and tail code paths both get hit at every alignment
+template < typename Tag >
+void  check_tags( std::vector<Tag> const &tags, Tag tag )
+{
+    using boost::unions::count_tag;
+    using boost::unions::find_tag;
+    using boost::unions::mask_tag;
+
+    for ( std::size_t  start = 0u ; start < 70u ; ++start )
+        for ( std::size_t  end = start ; end <= tags.size() ; end += 7u )
+        {
+            Tag const * const  first = tags.data() + start;
+            Tag const * const  last = tags.data() + end;
+            std::size_t        count = 0u;
+            Tag const *        found = last;
+            std::vector<std::uint64_t>  bits( (end - start + 63u) / 64u,
+                                         ~0ull ), expected( bits.size() );
+
+            for ( Tag const *p = last ; p != first ; )
+                if ( *--p == tag )
+                {
+                    ++count;
+                    found = p;
+                    expected[ (p - first) / 64 ] |= std::uint64_t{ 1u } << (
+                     (p - first) % 64 );
+                }
+            BOOST_TEST_EQ( count_tag(first, last, tag), count );
+            BOOST_TEST( find_tag(first, last, tag) == found );
+            BOOST_TEST_EQ( mask_tag(first, last, tag, bits.data()), count );
+            BOOST_TEST( bits == expected );
+        }
+}
+
+// Byte tags take the SIMD path, where there is one; wider ones don't
+void  test_tag_arrays()
+{
+    std::vector<unsigned char>  bytes( 200u );
+    std::vector<std::uint16_t>  words( 200u );
+
+    for ( std::size_t  i = 0u ; i < bytes.size() ; ++i )
+        words[ i ] = bytes[ i ] = ( i * 7u + i / 5u ) % 5u;
+    check_tags<unsigned char>( bytes, 3u );
+    check_tags<std::uint16_t>( words, 3u );
+
+    // Matches only at the very ends, and none at all
+    bytes.assign( 200u, 0u );
+    bytes.front() = bytes.back() = 255u;
+    check_tags<unsigned char>( bytes, 255u );
+    check_tags<unsigned char>( bytes, 9u );
+
+    // Long enough that per-lane tallies would overflow if never emptied
+    bytes.assign( 10000u, 4u );
+    bytes[ 5000 ] = 0u;
+    BOOST_TEST_EQ( boost::unions::count_tag(bytes.data(), bytes.data() +
+     bytes.size(), static_cast<unsigned char>( 4u )), 9999u );
+}
+
+// Scans by type, over the dense tags of a tagged_union_soa
+void  test_soa_scans()
+{
+    using boost::unions::count_alternative;
+    using boost::unions::find_alternative;
+    using boost::unions::mask_alternative;
+
+    boost::unions::tagged_union_soa<double, int, std::string>  e;
+
+    for ( int  i = 0 ; i < 150 ; ++i )
+        if ( i % 3 == 2 )
+            e.push_back( i );
+        else if ( i == 100 )
+            e.push_back( std::string("hundred") );
+        else if ( i == 120 )
+            e.push_empty();
+        else
+            e.push_back( 0.5 * i );
+
+    BOOST_TEST_EQ( count_alternative<int>(e), 50u );
+    BOOST_TEST_EQ( count_alternative<int>(e, 0u, 3u), 1u );
+    BOOST_TEST_EQ( count_alternative<int>(e, 3u, 150u), 49u );
+    BOOST_TEST_EQ( count_alternative<std::string>(e, 0u, 150u), 1u );
+    BOOST_TEST_EQ( count_alternative<double>(e, 64u, 128u), 41u );
+
+    BOOST_TEST_EQ( find_alternative<int>(e), 2u );
+    BOOST_TEST_EQ( find_alternative<int>(e, 3u), 5u );
+    BOOST_TEST_EQ( find_alternative<std::string>(e), 100u );
+    BOOST_TEST_EQ( find_alternative<std::string>(e, 101u), e.size() );
+
+    std::uint64_t  bits[ 3 ];
+
+    BOOST_TEST_EQ( mask_alternative<std::string>(e, bits), 1u );
+    BOOST_TEST_EQ( bits[0], 0u );
+    BOOST_TEST_EQ( bits[1], std::uint64_t{1u} << 36 );
+    BOOST_TEST_EQ( bits[2], 0u );
+    BOOST_TEST_EQ( mask_alternative<int>(e, bits), 50u );
+    BOOST_TEST_EQ( bits[0], 0x4924924924924924u );
+}
+
+// Scans by type, over a range of tagged_union
+void  test_union_scans()
+{
+    using boost::unions::count_alternative;
+    using boost::unions::find_alternative;
+    using boost::unions::mask_alternative;
+
+    typedef boost::unions::tagged_union<double, int, std::string>  event;
+
+    std::vector<event>  v;
+
+    for ( int  i = 0 ; i < 70 ; ++i )
+        if ( i % 3 == 2 )
+            v.emplace_back( i );
+        else if ( i == 64 )
+            v.emplace_back( std::string("sixty-four") );
+        else if ( i == 67 )
+            v.emplace_back();
+        else
+            v.emplace_back( 0.5 * i );
+
+    std::vector<event> const &  cv = v;
+
+    BOOST_TEST_EQ( count_alternative<int>(v.begin(), v.end()), 23u );
+    BOOST_TEST_EQ( count_alternative<double>(cv.begin(), cv.end()), 45u );
+    BOOST_TEST( find_alternative<int>(v.begin(), v.end()) == v.begin() + 2 );
+    BOOST_TEST( find_alternative<std::string>(cv.begin(), cv.end()) ==
+     cv.begin() + 64 );
+    BOOST_TEST( find_alternative<std::string>(v.begin(), v.begin() + 64) ==
+     v.begin() + 64 );
+
+    std::uint64_t  bits[ 2 ];
+
+    BOOST_TEST_EQ( mask_alternative<int>(v.begin(), v.end(), bits), 23u );
+    BOOST_TEST_EQ( bits[0], 0x4924924924924924u );
+    BOOST_TEST_EQ( bits[1], 0x12u );
+    BOOST_TEST_EQ( mask_alternative<std::string>(v.begin(), v.end(), bits),
+     1u );
+    BOOST_TEST_EQ( bits[0], 0u );
+    BOOST_TEST_EQ( bits[1], 0x1u );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_tag_arrays();
+    test_soa_scans();
+    test_union_scans();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,199 @@
+//  Boost Unions Library, tagged_union_queue run-time test file  -------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_queue.hpp"  // for ...::tagged_union_queue
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <atomic>     // for std::atomic
+#include <cstddef>    // for std::size_t
+#include <stdexcept>  // for std::runtime_error
+#include <string>     // for std::string
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+
+
+// A message that counts how it was made, and can be told to fail
+std::atomic<int>  built{ 0 }, copied{ 0 }, moved{ 0 };
+
+struct order
+{
+    int          id;
+    std::string  symbol;
+
+    order( int i, char const *s )
+        : id{ i }, symbol{ s }
+    {
+        if ( i < 0 )
+            throw std::runtime_error{ "bad order" };
+        ++built;
+    }
+    order( order const &that )
+        : id{ that.id }, symbol{ that.symbol }
+    { ++copied; }
+    order( order &&that ) noexcept
+        : id{ that.id }, symbol{ std::move(that.symbol) }
+    { ++moved; }
+    auto  operator =( order const & ) -> order & = default;
+    auto  operator =( order && ) -> order & = default;
+};
+
+typedef boost::unions::tagged_union<int, order>  message;
+
+// Records what it's given
+struct recorder
+{
+    std::vector<int> *  ids;
+
+    void  operator ()( int i ) const  { ids->push_back( -i ); }
+    void  operator ()( order &o ) const  { ids->push_back( o.id ); }
+};
+
+// Fails on whatever it's given
+struct thrower
+{
+    template < typename T >
+    void  operator ()( T const & ) const
+    { throw std::runtime_error{ "bad visit" }; }
+};
+
+using boost::unions::gett;
+
+
+// Order, capacity, and building in place
+void  test_one_thread()
+{
+    typedef boost::unions::tagged_union_queue<message, 4u>  queue_type;
+
+    queue_type        q;
+    std::vector<int>  ids;
+    recorder const    r{ &ids };
+
+    BOOST_TEST_EQ( q.capacity(), 4u );
+    BOOST_TEST( q.empty() );
+    BOOST_TEST( !q.try_visit(r) );
+    BOOST_TEST( q.try_emplace<order>(1, "ABC") );
+    BOOST_TEST( q.try_emplace<int>(2) );
+    BOOST_TEST( q.try_push(message{ 3 }) );
+    BOOST_TEST( q.try_emplace<order>(4, "XYZ") );
+    BOOST_TEST( !q.try_emplace<int>(5) );
+    BOOST_TEST_EQ( q.size(), 4u );
+
+    // Built once, then visited where it is
+    BOOST_TEST_EQ( built.load(), 2 );
+    BOOST_TEST_EQ( copied.load() + moved.load(), 0 );
+    while ( q.try_visit(r) )
+        ;
+    BOOST_TEST( ids == std::vector<int>({ 1, -2, -3, 4 }) );
+    BOOST_TEST_EQ( copied.load() + moved.load(), 0 );
+    BOOST_TEST( q.empty() );
+
+    // Around the ring a few times, moving messages out
+    message  m;
+
+    for ( int  i = 0 ; i < 10 ; ++i )
+    {
+        BOOST_TEST( q.try_emplace<order>(i, "DEF") );
+        BOOST_TEST( q.try_pop(m) );
+        BOOST_TEST( gett<order>(&m) && gett<order>(&m)->id == i );
+    }
+    BOOST_TEST( !q.try_pop(m) );
+
+    // A failed build is skipped; a throwing visitor still frees its slot
+    ids.clear();
+    BOOST_TEST_THROWS( q.try_emplace<order>(-1, "BAD"), std::runtime_error );
+    BOOST_TEST( q.try_emplace<int>(6) );
+    BOOST_TEST( q.try_visit(r) );
+    BOOST_TEST( ids == std::vector<int>({ -6 }) );
+    for ( int  i = 0 ; i < 4 ; ++i )
+        BOOST_TEST( q.try_emplace<int>(i) );
+    BOOST_TEST_THROWS( q.try_visit(thrower{}), std::runtime_error );
+    BOOST_TEST( q.try_emplace<int>(7) );
+    BOOST_TEST_EQ( q.size(), 4u );
+}
+
+// Producers and consumers at once; nothing lost or doubled, and each
+// consumer sees each producer's messages in order
+struct tally
+{
+    std::vector<int> *  last;  // per producer
+    long long *         sum;
+    std::size_t *       bad;
+
+    void  operator ()( int i ) const  { this->check( i ); }
+    void  operator ()( order &o ) const  { this->check( o.id ); }
+
+    void  check( int i ) const
+    {
+        int const  producer = i % 16, n = i / 16;
+
+        *bad += ( n <= (*last)[producer] );
+        (*last)[ producer ] = n;
+        *sum += n;
+    }
+};
+
+void  test_threads( int producers, int consumers )
+{
+    typedef boost::unions::tagged_union_queue<message, 64u>  queue_type;
+
+    int const                 count = 20000;
+    queue_type                q;
+    std::atomic<int>          producing{ producers };
+    std::atomic<long long>    total{ 0 };
+    std::atomic<std::size_t>  errors{ 0u };
+    std::vector<std::thread>  threads;
+
+    for ( int  p = 0 ; p < producers ; ++p )
+        threads.emplace_back( [&, p]{
+            for ( int  n = 0 ; n < count ; ++n )
+                if ( n % 2 )
+                    while ( !q.try_emplace<int>(n * 16 + p) )
+                        std::this_thread::yield();
+                else
+                    while ( !q.try_emplace<order>(n * 16 + p, "ABC") )
+                        std::this_thread::yield();
+            --producing;
+        } );
+    for ( int  c = 0 ; c < consumers ; ++c )
+        threads.emplace_back( [&]{
+            std::vector<int>  last( 16, -1 );
+            long long         sum = 0;
+            std::size_t       bad = 0u;
+            tally const       t{ &last, &sum, &bad };
+
+            for ( ;; )
+                if ( !q.try_visit(t) )
+                {
+                    if ( !producing && q.empty() )
+                        break;
+                    std::this_thread::yield();
+                }
+            total += sum;
+            errors += bad;
+        } );
+    for ( std::thread &t : threads )
+        t.join();
+    BOOST_TEST_EQ( total.load(), static_cast<long long>(producers) * count *
+     (count - 1) / 2 );
+    BOOST_TEST_EQ( errors.load(), 0u );
+    BOOST_TEST( q.empty() );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_one_thread();
+    test_threads( 1, 1 );
+    test_threads( 2, 2 );
+    test_threads( 4, 2 );
+    test_threads( 2, 4 );
+
+    return boost::report_errors();
+}
@@ -0,0 +1,167 @@
+//  Boost Unions Library, tagged_union_scheduler run-time test file  ---------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_scheduler.hpp"  // for ...scheduler
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <numeric>  // for std::accumulate, iota
+#include <set>      // for std::set
+#include <vector>   // for std::vector
+
+
+// Fork/join tasks: a Fibonacci number by recursive splitting, a sum of a
+// range by halving it, and a note of which thread ran it
+struct fib_task;
+struct sum_task;
+struct note_task;
+
+template < std::size_t Capacity >
+using scheduler = boost::unions::tagged_union_scheduler<
+ boost::unions::tagged_union<fib_task, sum_task, note_task>, Capacity>;
+
+// Count down "pending," for whoever waits on it
+void  done_with( std::atomic<int> *pending )
+{ pending->fetch_sub( 1, std::memory_order_release ); }
+
+struct fib_task
+{
+    int                 n;
+    long *              result;
+    std::atomic<int> *  pending;
+
+    template < class Worker >
+    void  operator ()( Worker &w ) const
+    {
+        if ( n < 2 )
+            *result = n;
+        else
+        {
+            long              a, b;
+            std::atomic<int>  children{ 2 };
+
+            w.template spawn<fib_task>( n - 1, &a, &children );
+            w.template spawn<fib_task>( n - 2, &b, &children );
+            w.help_until( [&]{ return !children.load(
+             std::memory_order_acquire ); } );
+            *result = a + b;
+        }
+        done_with( pending );
+    }
+};
+
+struct sum_task
+{
+    int const *         first;
+    int const *         last;
+    long long *         result;
+    std::atomic<int> *  pending;
+
+    template < class Worker >
+    void  operator ()( Worker &w ) const
+    {
+        if ( last - first <= 64 )
+            *result = std::accumulate( first, last, 0LL );
+        else
+        {
+            int const * const  middle = first + ( last - first ) / 2;
+            long long          a, b;
+            std::atomic<int>   children{ 2 };
+
+            w.spawn( typename Worker::value_type{sum_task{first,
+             middle, &a, &children}} );
+            w.template spawn<sum_task>( middle, last, &b, &children );
+            w.help_until( [&]{ return !children.load(
+             std::memory_order_acquire ); } );
+            *result = a + b;
+        }
+        done_with( pending );
+    }
+};
+
+struct note_task
+{
+    std::atomic<int> *  pending;
+    std::size_t *       worker_index;
+
+    template < class Worker >
+    void  operator ()( Worker &w ) const
+    {
+        *worker_index = w.index();
+        done_with( pending );
+    }
+};
+
+long  fib( int n )  { return n < 2 ? n : fib( n - 1 ) + fib( n - 2 ); }
+
+bool  finished( std::atomic<int> const &pending )
+{ return !pending.load( std::memory_order_acquire ); }
+
+
+// Fork/join from outside, with various pool and deque sizes; a full deque
+// runs its spawns at once
+template < std::size_t Capacity >
+void  test_fork_join( std::size_t threads )
+{
+    scheduler<Capacity>  pool{ threads };
+    std::atomic<int>     pending{ 2 };
+    long                 f = 0;
+    std::vector<int>     numbers( 100000 );
+    long long            s = 0;
+
+    BOOST_TEST_EQ( pool.size(), threads );
+    BOOST_TEST_EQ( pool.capacity(), Capacity );
+    std::iota( numbers.begin(), numbers.end(), 0 );
+    pool.template submit<fib_task>( 20, &f, &pending );
+    pool.submit( typename scheduler<Capacity>::value_type{sum_task{
+     numbers.data(), numbers.data() + numbers.size(), &s, &pending}} );
+    pool.wait_until( [&]{ return finished(pending); } );
+    BOOST_TEST_EQ( f, fib(20) );
+    BOOST_TEST_EQ( s, 99999LL * 100000LL / 2 );
+}
+
+// Many tasks from outside; each runs once, on some worker
+void  test_submissions()
+{
+    int const                 count = 1000;
+    scheduler<16u>            pool{ 3u };
+    std::atomic<int>          pending{ count };
+    std::vector<std::size_t>  ran( count, ~std::size_t{0u} );
+
+    for ( int  i = 0 ; i < count ; ++i )
+        pool.submit<note_task>( &pending, &ran[i] );
+    pool.wait_until( [&]{ return finished(pending); } );
+
+    std::set<std::size_t> const  workers( ran.begin(), ran.end() );
+
+    BOOST_TEST( !workers.empty() && *workers.rbegin() < pool.size() );
+
+    // Empty unions are ignored; pointers-to-self mean nothing to a worker
+    typedef scheduler<16u>::value_type  task_type;
+
+    task_type const  self{ &self };
+
+    pool.submit( task_type{} );
+    BOOST_TEST_THROWS( pool.submit(self), boost::bad_get );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_fork_join<1024u>( 1u );
+    test_fork_join<1024u>( 2u );
+    test_fork_join<1024u>( 4u );
+    test_fork_join<2u>( 1u );
+    test_fork_join<2u>( 3u );
+    test_submissions();
+
+    return boost::report_errors();
+}
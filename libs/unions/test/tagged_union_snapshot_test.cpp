@@ -0,0 +1,187 @@
+//  Boost Unions Library, tagged_union_snapshot run-time test file  ----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_snapshot.hpp"  // for tagged_union_snapshot
+#include "boost/unions/tagged_union.hpp"           // for ...::tagged_union
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for std::size_t
+#include <thread>       // for std::thread
+#include <type_traits>  // for std::is_constructible
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+
+// Large versions of two shapes, each filled with its version number, and
+// counted so leaks and early frees show
+std::atomic<int>  live{ 0 };
+
+template < int Tag >
+struct table
+{
+    unsigned  version;
+    unsigned  entries[ 64 ];
+
+    explicit  table( unsigned v )
+        : version{ v }
+    {
+        for ( unsigned &e : entries )
+            e = v;
+        ++live;
+    }
+    table( table const &that )
+        : version{ that.version }
+    {
+        for ( std::size_t  i = 0u ; i < 64u ; ++i )
+            entries[ i ] = that.entries[ i ];
+        ++live;
+    }
+    ~table()  { version = ~0u; --live; }
+
+    bool  whole() const
+    {
+        for ( unsigned  e : entries )
+            if ( e != version )
+                return false;
+        return true;
+    }
+};
+
+typedef boost::unions::tagged_union<table<0>, table<1>>  config;
+typedef boost::unions::tagged_union_snapshot<config>     cell_type;
+
+using boost::unions::gett;
+
+static_assert( std::is_constructible<cell_type, table<1>>::value, "" );
+static_assert( !std::is_constructible<cell_type, cell_type &>::value,
+ "Can't be copied" );
+static_assert( !std::is_constructible<cell_type, int *>::value, "" );
+
+// The version number of "c," or ~0 if it isn't whole
+unsigned  version_of( config const &c )
+{
+    if ( table<0> const * const  t = gett<table<0>>(&c) )
+        return t->whole() ? t->version : ~0u;
+    if ( table<1> const * const  t = gett<table<1>>(&c) )
+        return t->whole() ? t->version : ~0u;
+    return ~0u;
+}
+
+config  make_config( unsigned v )
+{
+    return ( v % 2u ) ? config{ table<1>{v} } : config{ table<0>{v} };
+}
+
+
+// Views keep their versions alive until they end
+void  test_views()
+{
+    {
+        cell_type  cell{ table<0>{0u} };
+        auto       r1 = cell.make_reader(), r2 = cell.make_reader();
+
+        BOOST_TEST_EQ( live.load(), 1 );
+        {
+            auto const  v1 = r1.read();
+
+            cell.store( make_config(1u) );
+            BOOST_TEST_EQ( live.load(), 2 );
+
+            auto const  v2 = r2.read();
+
+            cell.emplace( table<0>{2u} );
+            BOOST_TEST_EQ( version_of(*v1), 0u );
+            BOOST_TEST_EQ( version_of(v2.get()), 1u );
+            BOOST_TEST_EQ( live.load(), 3 );
+            BOOST_TEST_EQ( cell.reclaim(), 2u );
+        }
+        BOOST_TEST_EQ( cell.reclaim(), 0u );
+        BOOST_TEST_EQ( live.load(), 1 );
+
+        // A version no one saw goes right away
+        cell.store( make_config(3u) );
+        BOOST_TEST_EQ( live.load(), 1 );
+        BOOST_TEST_EQ( version_of(r1.read().get()), 3u );
+
+        // A view holds back its version and, since epochs can't tell who saw
+        // what, the ones retired after; then it lets them all go
+        {
+            auto const  v = r2.read();
+
+            for ( unsigned  i = 4u ; i < 10u ; ++i )
+                cell.store( make_config(i) );
+            BOOST_TEST_EQ( version_of(*v), 3u );
+            BOOST_TEST_EQ( live.load(), 7 );
+        }
+        cell.store( make_config(10u) );
+        BOOST_TEST_EQ( live.load(), 1 );
+
+        // A slot given back is reused
+        {
+            auto  r3 = cell.make_reader();
+            auto  r4 = std::move( r3 );
+
+            BOOST_TEST_EQ( version_of(*r4.read()), 10u );
+        }
+        auto const  r5 = cell.make_reader();
+
+        BOOST_TEST_EQ( version_of(*r5.read()), 10u );
+    }
+    BOOST_TEST_EQ( live.load(), 0 );
+}
+
+// One writer, several readers; every view is whole, and never goes back
+void  test_threads()
+{
+    {
+        unsigned const            versions = 3000u;
+        int const                 readers = 3;
+        cell_type                 cell{ table<0>{0u} };
+        std::atomic<bool>         done{ false };
+        std::atomic<std::size_t>  bad{ 0u }, reads{ 0u };
+        std::vector<std::thread>  threads;
+
+        for ( int  i = 0 ; i < readers ; ++i )
+            threads.emplace_back( [&]{
+                auto      r = cell.make_reader();
+                unsigned  last = 0u;
+
+                do
+                {
+                    auto const      v = r.read();
+                    unsigned const  n = version_of( *v );
+
+                    bad += ( n == ~0u ) || ( n < last );
+                    last = n;
+                    ++reads;
+                } while ( !done );
+            } );
+        for ( unsigned  i = 1u ; i <= versions ; ++i )
+            cell.store( make_config(i) );
+        done = true;
+        for ( std::thread &t : threads )
+            t.join();
+        BOOST_TEST_EQ( bad.load(), 0u );
+        BOOST_TEST( reads.load() > 0u );
+        BOOST_TEST_EQ( cell.reclaim(), 0u );
+        BOOST_TEST_EQ( live.load(), 1 );
+    }
+    BOOST_TEST_EQ( live.load(), 0 );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_views();
+    test_threads();
+
+    return boost::report_errors();
+}
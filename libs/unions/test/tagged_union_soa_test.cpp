@@ -0,0 +1,124 @@
+//  Boost Unions Library, tagged_union_soa run-time test file  ---------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_soa.hpp"  // for ...::tagged_union_soa
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstdint>      // for std::uint8_t
+#include <string>       // for std::string
+#include <type_traits>  // for std::is_same
+
+
+// The container we'll be working with
+typedef boost::unions::tagged_union_soa<double, int, std::string>  events;
+
+
+// Each type's objects sit together, in order, apart from the tags
+void  test_layout()
+{
+    static_assert( std::is_same<events::tag_type, std::uint8_t>::value, "" );
+    static_assert( std::is_same<events::value_type,
+     boost::unions::tagged_union<double, int, std::string>>::value, "" );
+
+    events  e;
+
+    BOOST_TEST( e.empty() );
+    BOOST_TEST_EQ( e.push_back(1.5), 0u );
+    BOOST_TEST_EQ( e.push_back(7), 1u );
+    BOOST_TEST_EQ( e.emplace_back<std::string>(3u, 's'), 2u );
+    BOOST_TEST_EQ( e.push_back(2.5), 3u );
+    BOOST_TEST_EQ( e.push_empty(), 4u );
+    BOOST_TEST_EQ( e.push_back(-3), 5u );
+
+    BOOST_TEST_EQ( e.size(), 6u );
+    BOOST_TEST_EQ( e.count<double>(), 2u );
+    BOOST_TEST_EQ( e.count<int>(), 2u );
+    BOOST_TEST_EQ( e.count<std::string>(), 1u );
+    BOOST_TEST_EQ( e.data<double>()[1], 2.5 );
+    BOOST_TEST_EQ( e.data<int>()[1], -3 );
+    BOOST_TEST_EQ( e.tags()[2], 2u );
+    BOOST_TEST_EQ( e.stored_index(4u), events::empty_index() );
+}
+
+// Logical indices reach the right object, and stay put
+void  test_access()
+{
+    events  e;
+
+    e.push_back( 4 );
+    e.push_back( std::string("four") );
+    e.push_empty();
+    for ( int  i = 0 ; i < 100 ; ++i )
+        e.push_back( 0.5 * i );
+
+    BOOST_TEST_EQ( *e.gett<int>(0u), 4 );
+    BOOST_TEST_EQ( *e.gett<std::string>(1u), "four" );
+    BOOST_TEST( !e.gett<int>(1u) );
+    BOOST_TEST( !e.gett<double>(2u) );
+    BOOST_TEST_EQ( *e.gett<double>(3u + 40u), 20.0 );
+
+    *e.gett<int>( 0u ) = 8;
+    BOOST_TEST_EQ( boost::unions::gett<int>(e.at(0u)), 8 );
+    BOOST_TEST_EQ( e.at(2u).stored_index(), events::value_type::empty_index() );
+
+    // Whole unions go in and come back out
+    events::value_type const  u{ std::string("whole") }, self{
+     static_cast<events::value_type const *>(&u) };
+
+    BOOST_TEST_EQ( e.push_back(u), 103u );
+    BOOST_TEST_EQ( boost::unions::gett<std::string>(e.at(103u)), "whole" );
+    BOOST_TEST_EQ( e.push_back(events::value_type{}), 104u );
+    BOOST_TEST_THROWS( e.push_back(self), boost::bad_get );
+    BOOST_TEST_EQ( e.size(), 105u );
+
+    e.clear();
+    BOOST_TEST( e.empty() );
+    BOOST_TEST_EQ( e.count<double>(), 0u );
+}
+
+// Kernels run over one type's array
+void  test_for_each()
+{
+    events  e;
+
+    for ( int  i = 0 ; i < 10 ; ++i )
+    {
+        e.push_back( i );
+        e.push_back( 0.25 * i );
+    }
+
+    struct summer
+    {
+        double  sum;
+
+        void  operator ()( double x )  { sum += x; }
+    };
+
+    BOOST_TEST_EQ( e.for_each<double>(summer{ 0.0 }).sum, 11.25 );
+
+    e.for_each<int>( []( int &x ){ x *= 2; } );
+    BOOST_TEST_EQ( *e.gett<int>(18u), 18 );
+
+    events const &  c = e;
+    int             total = 0;
+
+    c.for_each<int>( [&total]( int x ){ total += x; } );
+    BOOST_TEST_EQ( total, 90 );
+}
+
+
+// Main program
+int  main()
+{
+    test_layout();
+    test_access();
+    test_for_each();
+
+    return boost::report_errors();
+}
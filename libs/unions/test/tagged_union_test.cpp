@@ -0,0 +1,896 @@
+//  Boost Unions Library, tagged_union run-time test file  -------------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for boost::unions::tagged_union
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <algorithm>    // for std::stable_sort
+#include <cstddef>      // for std::size_t
+#include <cstring>      // for std::memcpy
+#include <string>       // for std::string
+#include <type_traits>  // for std::is_same, is_convertible, etc.
+#include <typeinfo>     // for std::type_info
+#include <utility>      // for std::move, swap
+#include <vector>       // for std::vector
+
+
+// Types that keep track of how many of them are alive
+template < int N >
+struct counted
+{
+    static int  live;
+
+    int  value;
+
+    explicit counted( int v ) : value( v )  { ++live; }
+    counted( counted const &that ) : value( that.value )  { ++live; }
+    counted( counted &&that ) : value( that.value )  { ++live; }
+    ~counted()  { --live; }
+
+    counted &  operator =( counted const & ) = default;
+    counted &  operator =( counted && ) = default;
+};
+
+template < int N >
+int  counted<N>::live = 0;
+
+// The union we'll be working with...
+typedef boost::unions::tagged_union<counted<0>, counted<1>, counted<2>,
+ std::string>  test_union;
+
+// ...And the access functions needed.
+using boost::unions::gett;
+using boost::unions::get;
+using boost::unions::visit;
+
+
+// Every alternative gets the same bookkeeping, regardless of position
+void  test_alternative_indices()
+{
+    test_union  t0{ counted<0>{1} }, t1{ counted<1>{2} }, t2{ counted<2>{3} },
+                t3{ std::string("four") }, te;
+
+    BOOST_TEST_EQ( t0.stored_index(), 0u );
+    BOOST_TEST_EQ( t1.stored_index(), 1u );
+    BOOST_TEST_EQ( t2.stored_index(), 2u );
+    BOOST_TEST_EQ( t3.stored_index(), 3u );
+    BOOST_TEST_EQ( te.stored_index(), test_union::empty_index() );
+    BOOST_TEST_EQ( test_union::index_of<std::string>(), 3u );
+    BOOST_TEST_EQ( test_union::index_of<test_union const *>(), 5u );
+    BOOST_TEST_EQ( test_union::index_of<double>(), test_union::empty_index() );
+
+    BOOST_TEST( *t2.stored_type() == typeid(counted<2>) );
+    BOOST_TEST( *t3.stored_type() == typeid(std::string) );
+    BOOST_TEST( !te.stored_type() );
+    BOOST_TEST( !te.data() );
+    BOOST_TEST( !gett<double>(&te) );
+    BOOST_TEST( !gett<counted<0>>(&te) );
+    BOOST_TEST( gett<counted<2>>(&t2) );
+    BOOST_TEST( !gett<counted<1>>(&t2) );
+    BOOST_TEST_EQ( get<3>(t3), "four" );
+}
+
+// Copying, moving, assigning, and destroying go to the right alternative
+void  test_special_members()
+{
+    {
+        test_union  a{ counted<2>{5} };
+        test_union  b{ a };
+        test_union  c{ std::move(b) };
+
+        BOOST_TEST_EQ( counted<2>::live, 3 );
+        BOOST_TEST_EQ( gett<counted<2>>(c).value, 5 );
+
+        b = test_union{ counted<0>{7} };
+        BOOST_TEST_EQ( counted<2>::live, 2 );
+        BOOST_TEST_EQ( counted<0>::live, 1 );
+        BOOST_TEST_EQ( gett<counted<0>>(b).value, 7 );
+
+        a = b;
+        BOOST_TEST_EQ( counted<2>::live, 1 );
+        BOOST_TEST_EQ( counted<0>::live, 2 );
+
+        c = test_union{};
+        BOOST_TEST_EQ( counted<2>::live, 0 );
+        BOOST_TEST( !c.stored_type() );
+
+        c = a;
+        b = std::string( "five" );
+        BOOST_TEST_EQ( counted<0>::live, 2 );
+        BOOST_TEST_EQ( gett<std::string>(b), "five" );
+    }
+    BOOST_TEST_EQ( counted<0>::live, 0 );
+    BOOST_TEST_EQ( counted<1>::live, 0 );
+    BOOST_TEST_EQ( counted<2>::live, 0 );
+}
+
+// Pointers to self come after the listed types
+void  test_pointer_to_self()
+{
+    test_union        a{ counted<1>{9} };
+    test_union        b{ static_cast<test_union const *>(&a) };
+    test_union const  c{ b };
+
+    BOOST_TEST( b.storing_pointer_to_self() );
+    BOOST_TEST( !a.storing_pointer_to_self() );
+    BOOST_TEST_EQ( b.stored_index(), 5u );
+    BOOST_TEST( *c.stored_type() == typeid(test_union const *) );
+    BOOST_TEST( !gett<test_union *>(&c) );
+    BOOST_TEST_EQ( gett<test_union const *>(c), &a );
+    BOOST_TEST_EQ( gett<counted<1>>(*gett<test_union const *>(c)).value, 9 );
+
+    a = b;
+    BOOST_TEST( a.storing_pointer_to_self() );
+    BOOST_TEST_EQ( counted<1>::live, 0 );
+}
+
+// The tag is one byte, and the pointer-to-self status comes from it
+void  test_compact_tag()
+{
+    typedef boost::unions::tagged_union<int, float>  small_union;
+
+    BOOST_TEST_EQ( sizeof(small_union::index_type), 1u );
+    BOOST_TEST_EQ( sizeof(test_union::index_type), 1u );
+
+    small_union  s1{ 3.5f }, s2{ static_cast<small_union volatile *>(&s1) };
+
+    BOOST_TEST( !s1.storing_pointer_to_self() );
+    BOOST_TEST( s2.storing_pointer_to_self() );
+    BOOST_TEST( *s2.stored_type() == typeid(small_union volatile *) );
+    BOOST_TEST( !small_union{}.storing_pointer_to_self() );
+}
+
+// Visitors for the visitation tests
+struct describer
+{
+    template < int N >
+    std::string  operator ()( counted<N> const &c ) const
+    { return "counted<" + std::to_string( N ) + ">=" + std::to_string(c.value); }
+
+    std::string  operator ()( std::string const &s ) const  { return s; }
+};
+
+struct pair_summer
+{
+    long  operator ()( int a, int b ) const  { return 10 * a + b; }
+    int   operator ()( int a, double b ) const  { return 10 * a + int( b ); }
+    template < typename T >
+    int   operator ()( double, T ) const  { return -1; }
+};
+
+struct triple_indexer
+{
+    template < typename T, typename U, typename V >
+    std::size_t  operator ()( T const &, U const &, V const & ) const
+    { return sizeof(T) * 100u + sizeof(U) * 10u + sizeof(V); }
+};
+
+struct referrer
+{
+    template < typename T >
+    T &  operator ()( T &t ) const  { return t; }
+};
+
+struct doubler
+{
+    template < typename T >
+    void  operator ()( T &t ) const  { t *= 2; }
+};
+
+struct taker
+{
+    template < int N >
+    std::string  operator ()( counted<N> && ) const  { return {}; }
+
+    std::string  operator ()( std::string &&s ) const  { return std::move(s); }
+};
+
+struct self_follower
+{
+    template < typename T >
+    int  operator ()( T const & ) const  { return 0; }
+
+    int  operator ()( boost::unions::tagged_union<int, char> const *p ) const
+    { return 1 + visit( *this, *p ); }
+};
+
+// Visit one or more unions with a result computed from the variant members
+void  test_visit()
+{
+    typedef boost::unions::tagged_union<int, double>         id_union;
+    typedef boost::unions::tagged_union<char, short, float>  csf_union;
+
+    test_union const  t0{ counted<0>{4} }, t3{ std::string("text") }, te;
+
+    BOOST_TEST_EQ( visit(describer{}, t0), "counted<0>=4" );
+    BOOST_TEST_EQ( visit(describer{}, t3), "text" );
+    BOOST_TEST_THROWS( visit(describer{}, te), boost::bad_get );
+
+    id_union const  i{ 3 }, d{ 4.5 }, e;
+
+    static_assert( std::is_same<decltype(visit( pair_summer{}, i, d )),
+     long>::value, "results should have been merged by std::common_type" );
+    BOOST_TEST_EQ( visit(pair_summer{}, i, id_union{ 2 }), 32 );
+    BOOST_TEST_EQ( visit(pair_summer{}, i, d), 34 );
+    BOOST_TEST_EQ( visit(pair_summer{}, d, i), -1 );
+    BOOST_TEST_THROWS( visit(pair_summer{}, i, e), boost::bad_get );
+
+    csf_union const  c{ 'a' }, s{ short(2) }, f{ 1.5f };
+
+    BOOST_TEST_EQ( visit(triple_indexer{}, c, s, f), 124u );
+    BOOST_TEST_EQ( visit(triple_indexer{}, f, c, i), 414u );
+    BOOST_TEST_EQ( visit(triple_indexer{}, d, f, s), 842u );
+    BOOST_TEST_EQ( visit([]{ return 7; }), 7 );
+
+    id_union                               m{ 1.25 };
+    boost::unions::tagged_union<unsigned>  u{ 6u };
+
+    visit( doubler{}, m );
+    BOOST_TEST_EQ( gett<double>(m), 2.5 );
+    static_assert( std::is_same<decltype(visit( referrer{}, u )), unsigned &
+     >::value, "a common result type should be kept as-is" );
+    visit( referrer{}, u ) = 8u;
+    BOOST_TEST_EQ( gett<unsigned>(u), 8u );
+
+    test_union  t{ std::string("moved") };
+
+    BOOST_TEST_EQ( visit(taker{}, std::move( t )), "moved" );
+    BOOST_TEST( gett<std::string>(t).empty() );
+
+    typedef boost::unions::tagged_union<int, char>  ic_union;
+
+    ic_union const  leaf{ 'z' }, mid{ &leaf }, top{ &mid };
+
+    BOOST_TEST_EQ( visit(self_follower{}, top), 2 );
+    BOOST_TEST_THROWS( visit(describer{}, test_union{ &t }), boost::bad_get );
+}
+
+// Special members are trivial exactly when the variant types' are
+void  test_triviality()
+{
+    typedef boost::unions::tagged_union<int, double, float *>  pod_union;
+    typedef boost::unions::tagged_union<int, std::string>      mixed_union;
+
+    static_assert( std::is_trivially_copyable<pod_union>::value, "" );
+    static_assert( std::is_trivially_copy_constructible<pod_union>::value, "" );
+    static_assert( std::is_trivially_move_constructible<pod_union>::value, "" );
+    static_assert( std::is_trivially_copy_assignable<pod_union>::value, "" );
+    static_assert( std::is_trivially_move_assignable<pod_union>::value, "" );
+    static_assert( std::is_trivially_destructible<pod_union>::value, "" );
+    static_assert( std::is_nothrow_default_constructible<pod_union>::value, ""
+     );
+    static_assert( std::is_trivially_copyable<boost::unions::tagged_union<>
+     >::value, "" );
+
+    static_assert( !std::is_trivially_copyable<mixed_union>::value, "" );
+    static_assert( !std::is_trivially_copy_constructible<mixed_union>::value,
+     "" );
+    static_assert( !std::is_trivially_destructible<mixed_union>::value, "" );
+    static_assert( !std::is_trivially_copyable<test_union>::value, "" );
+    static_assert( !std::is_trivially_destructible<test_union>::value, "" );
+
+    pod_union        p1{ 2.5 }, p2{ &p1 }, p3;
+    float            f = 1.0f;
+    pod_union const  p4{ &f };
+
+    std::memcpy( &p3, &p1, sizeof(p3) );
+    BOOST_TEST_EQ( gett<double>(p3), 2.5 );
+    p3 = p4;
+    BOOST_TEST_EQ( gett<float *>(p3), &f );
+    p3 = std::move( p2 );
+    BOOST_TEST_EQ( gett<pod_union *>(p3), &p1 );
+    BOOST_TEST( p3.storing_pointer_to_self() );
+
+    mixed_union  m1{ std::string("mixed") }, m2{ m1 };
+
+    m1 = 4;
+    BOOST_TEST_EQ( gett<std::string>(m2), "mixed" );
+    m2 = std::move( m1 );
+    BOOST_TEST_EQ( gett<int>(m2), 4 );
+}
+
+// Storage follows the strictest alignment, and the policy can raise it
+struct alignas( 64 ) wide
+{
+    unsigned char  bytes[ 64 ];
+};
+
+struct alignas( 32 ) vec8
+{
+    float  lanes[ 8 ];
+};
+
+void  test_alignment()
+{
+    using boost::unions::basic_tagged_union;
+    using boost::unions::cache_line_union_policy;
+
+    typedef boost::unions::tagged_union<int, float>         small_union;
+    typedef boost::unions::tagged_union<char, wide>         wide_union;
+    typedef boost::unions::tagged_union<int, vec8>          vec_union;
+    typedef basic_tagged_union<cache_line_union_policy, int>  line_union;
+
+    BOOST_TEST_EQ( sizeof(small_union), 2u * sizeof(void *) );
+    BOOST_TEST_EQ( alignof(small_union), alignof(void *) );
+    BOOST_TEST_EQ( alignof(wide_union), 64u );
+    BOOST_TEST_EQ( sizeof(wide_union), 128u );
+    BOOST_TEST_EQ( alignof(vec_union), 32u );
+    BOOST_TEST_EQ( alignof(line_union), BOOST_UNIONS_CACHE_LINE_SIZE );
+    BOOST_TEST_EQ( sizeof(line_union), BOOST_UNIONS_CACHE_LINE_SIZE );
+    static_assert( std::is_trivially_copyable<line_union>::value, "" );
+
+    vec_union  v{ vec8{} };
+
+    BOOST_TEST_EQ( reinterpret_cast<std::size_t>(v.data()) % 32u, 0u );
+
+    line_union  lines[ 2 ] = { line_union{ 5 }, line_union{ &lines[0] } };
+
+    BOOST_TEST_EQ( reinterpret_cast<char *>(&lines[ 1 ]) - reinterpret_cast<
+     char *>(&lines[ 0 ]), BOOST_UNIONS_CACHE_LINE_SIZE );
+    BOOST_TEST_EQ( gett<int>(*gett<line_union *>(lines[ 1 ])), 5 );
+    BOOST_TEST_EQ( visit(referrer{}, lines[ 0 ]), 5 );
+}
+
+// A type that counts calls to its own swap
+struct swappable
+{
+    static int  swaps;
+
+    int  value;
+
+    explicit swappable( int v ) : value( v )  {}
+    swappable( swappable const & ) = default;
+    ~swappable()  {}
+
+    swappable &  operator =( swappable const & ) = default;
+};
+
+int  swappable::swaps = 0;
+
+void  swap( swappable &a, swappable &b )
+{
+    std::swap( a.value, b.value );
+    ++swappable::swaps;
+}
+
+// Swapping uses the member's swap, the raw bytes, or a temporary, as needed
+void  test_swap()
+{
+    typedef boost::unions::tagged_union<int, double, float *>  pod_union;
+    typedef boost::unions::tagged_union<int, swappable, std::string>
+      mixed_union;
+
+    pod_union  p1{ 3 }, p2{ 2.5 }, p3;
+
+    swap( p1, p2 );
+    BOOST_TEST_EQ( gett<double>(p1), 2.5 );
+    BOOST_TEST_EQ( gett<int>(p2), 3 );
+    p1.swap( p3 );
+    BOOST_TEST( !p1.stored_type() );
+    BOOST_TEST_EQ( gett<double>(p3), 2.5 );
+    p1 = &p2;
+    std::swap( p1, p3 );
+    BOOST_TEST_EQ( gett<pod_union *>(p3), &p2 );
+    static_assert( noexcept(p1.swap( p2 )), "" );
+
+    mixed_union  m1{ swappable{1} }, m2{ swappable{2} };
+
+    swap( m1, m2 );
+    BOOST_TEST_EQ( swappable::swaps, 1 );
+    BOOST_TEST_EQ( gett<swappable>(m1).value, 2 );
+    BOOST_TEST_EQ( gett<swappable>(m2).value, 1 );
+
+    mixed_union  m3{ std::string("three") }, m4{ 4 }, m5;
+
+    swap( m1, m3 );
+    BOOST_TEST_EQ( gett<std::string>(m1), "three" );
+    BOOST_TEST_EQ( gett<swappable>(m3).value, 2 );
+    m3.swap( m4 );
+    BOOST_TEST_EQ( gett<int>(m3), 4 );
+    BOOST_TEST_EQ( gett<swappable>(m4).value, 2 );
+    m1.swap( m5 );
+    BOOST_TEST( !m1.stored_type() );
+    BOOST_TEST_EQ( gett<std::string>(m5), "three" );
+    m3.swap( m5 );
+    BOOST_TEST_EQ( gett<std::string>(m3), "three" );
+    BOOST_TEST_EQ( gett<int>(m5), 4 );
+    BOOST_TEST_EQ( swappable::swaps, 1 );
+
+    m5 = &m4;
+    m3.swap( m5 );
+    BOOST_TEST_EQ( gett<mixed_union *>(m3), &m4 );
+    BOOST_TEST_EQ( gett<std::string>(m5), "three" );
+}
+
+// A type whose copies can be made to fail
+struct fragile
+{
+    static bool  fail;
+
+    int  value;
+
+    explicit fragile( int v ) : value( v )  {}
+    fragile( fragile const &that ) : value( that.value )
+    { if ( fail ) throw 0; }
+    fragile( fragile &&that ) noexcept : value( that.value )  {}
+    ~fragile()  {}
+
+    fragile &  operator =( fragile const & ) = default;
+};
+
+bool  fragile::fail = false;
+
+// Assign a failing copy over a string, and report what's left
+template < class Guarantee >
+std::size_t  failed_assignment_index()
+{
+    typedef boost::unions::basic_tagged_union<boost::unions::union_policy<0u,
+     Guarantee>, fragile, std::string>  union_type;
+
+    union_type const  source{ fragile{1} };
+    union_type        target{ std::string("kept") };
+
+    fragile::fail = true;
+    BOOST_TEST_THROWS( target = source, int );
+    fragile::fail = false;
+    if ( auto const  s = gett<std::string>(&target) )
+        BOOST_TEST_EQ( *s, "kept" );
+
+    target = source;
+    BOOST_TEST_EQ( gett<fragile>(target).value, 1 );
+    target = std::string( "back" );
+    BOOST_TEST_EQ( gett<std::string>(target), "back" );
+
+    fragile::fail = true;
+    BOOST_TEST_THROWS( target = source, int );
+    fragile::fail = false;
+    return target.stored_index();
+}
+
+// The guarantee policy decides what a throwing change of type leaves behind
+void  test_guarantees()
+{
+    using boost::unions::basic_guarantee;
+    using boost::unions::relocating_guarantee;
+    using boost::unions::strong_guarantee;
+    using boost::unions::never_empty_guarantee;
+
+    BOOST_TEST_EQ( failed_assignment_index<basic_guarantee>(), 2u + 4u );
+    BOOST_TEST_EQ( failed_assignment_index<relocating_guarantee>(), 1u );
+    BOOST_TEST_EQ( failed_assignment_index<strong_guarantee>(), 1u );
+    BOOST_TEST_EQ( failed_assignment_index<never_empty_guarantee>(), 1u );
+
+    typedef boost::unions::basic_tagged_union<boost::unions::union_policy<0u,
+     never_empty_guarantee>, int, double>  doubled_union;
+
+    static_assert( sizeof(doubled_union) > 2u * sizeof(double), "" );
+    static_assert( std::is_trivially_copyable<doubled_union>::value, "" );
+
+    doubled_union  d1{ 2.5 }, d2{ 7 };
+
+    d1 = d2;
+    BOOST_TEST_EQ( gett<int>(d1), 7 );
+    d2 = 0.5;
+    BOOST_TEST_EQ( gett<double>(d2), 0.5 );
+
+    // Successful changes of type work the same under every policy
+    typedef boost::unions::basic_tagged_union<boost::unions::union_policy<0u,
+     basic_guarantee>, counted<0>, std::string>  basic_union;
+
+    {
+        basic_union const  c{ counted<0>{3} };
+        basic_union        s{ std::string("s") };
+
+        s = c;
+        BOOST_TEST_EQ( gett<counted<0>>(s).value, 3 );
+        BOOST_TEST_EQ( counted<0>::live, 2 );
+    }
+    BOOST_TEST_EQ( counted<0>::live, 0 );
+}
+
+// A type that counts its copies and moves, and whose construction can fail
+struct built
+{
+    static int  transfers;
+
+    int  sum;
+
+    built( int a, int b ) : sum( a + b )  { if ( b < 0 ) throw 0; }
+    built( built const &that ) : sum( that.sum )  { ++transfers; }
+    built( built &&that ) : sum( that.sum )  { ++transfers; }
+    ~built()  {}
+
+    built &  operator =( built const & ) = default;
+};
+
+int  built::transfers = 0;
+
+// Emplacing builds the object in the union, with no temporaries
+void  test_emplace()
+{
+    using boost::unions::in_place_type_t;
+    using boost::unions::in_place_index_t;
+
+    typedef boost::unions::tagged_union<int, built, built, std::string>
+      repeat_union;
+
+    repeat_union  a{ in_place_type_t<built>{}, 2, 3 };
+    repeat_union  b{ in_place_index_t<2u>{}, 4, 5 };
+    repeat_union  c{ in_place_type_t<std::string>{}, 3u, 'x' };
+
+    BOOST_TEST_EQ( a.stored_index(), 1u );
+    BOOST_TEST_EQ( gett<built>(a).sum, 5 );
+    BOOST_TEST_EQ( b.stored_index(), 1u );  // repeats go by type, like get
+    BOOST_TEST_EQ( get<2>(b).sum, 9 );
+    BOOST_TEST_EQ( gett<std::string>(c), "xxx" );
+
+    built &  r = c.emplace<built>( 6, 1 );
+
+    BOOST_TEST_EQ( c.stored_index(), 1u );
+    BOOST_TEST_EQ( &r, gett<built>(&c) );
+    BOOST_TEST_EQ( r.sum, 7 );
+    BOOST_TEST_EQ( c.emplace<2>(1, 1).sum, 2 );
+    BOOST_TEST_EQ( c.stored_index(), 1u );
+    BOOST_TEST_EQ( c.emplace<int>(8), 8 );
+    BOOST_TEST_EQ( c.emplace<std::string>("back"), "back" );
+    BOOST_TEST_EQ( built::transfers, 0 );
+
+    // A failed build leaves what the policy says; the default keeps the old
+    BOOST_TEST_THROWS( c.emplace<built>(1, -1), int );
+    BOOST_TEST_EQ( gett<std::string>(c), "back" );
+    BOOST_TEST_THROWS( (repeat_union{ in_place_index_t<1u>{}, 1, -1 }), int );
+    BOOST_TEST_EQ( built::transfers, 0 );
+
+    static_assert( noexcept(a.emplace<int>(1)), "" );
+    static_assert( !noexcept(a.emplace<built>(1, 2)), "" );
+}
+
+// A type that counts its copies and moves apart, and whose moves can be made
+// to allow throwing
+template < bool NothrowMove >
+struct tallied
+{
+    static int  copies, moves;
+
+    int  value;
+
+    explicit tallied( int v ) : value( v )  {}
+    tallied( tallied const &that ) : value( that.value )  { ++copies; }
+    tallied( tallied &&that ) noexcept( NothrowMove ) : value( that.value )
+    { ++moves; }
+    ~tallied()  {}
+
+    tallied &  operator =( tallied const & ) = default;
+    tallied &  operator =( tallied && ) = default;
+};
+
+template < bool NothrowMove >
+int  tallied<NothrowMove>::copies = 0;
+template < bool NothrowMove >
+int  tallied<NothrowMove>::moves = 0;
+
+// Moving never copies, and is noexcept when every type's moves are
+void  test_moves()
+{
+    typedef boost::unions::tagged_union<int, tallied<true>, std::string>
+      nothrow_union;
+    typedef boost::unions::tagged_union<int, tallied<false>, std::string>
+      throwing_union;
+
+    static_assert( std::is_nothrow_move_constructible<nothrow_union>::value,
+     "" );
+    static_assert( std::is_nothrow_move_assignable<nothrow_union>::value, "" );
+    static_assert( !std::is_nothrow_move_constructible<throwing_union>::value,
+     "" );
+    static_assert( !std::is_nothrow_move_assignable<throwing_union>::value,
+     "" );
+
+    // Changing type by move
+    nothrow_union  target{ 1 }, source{ tallied<true>{2} };
+
+    tallied<true>::moves = 0;
+    target = std::move( source );
+    BOOST_TEST_EQ( gett<tallied<true>>(target).value, 2 );
+    BOOST_TEST_EQ( tallied<true>::copies, 0 );
+    BOOST_TEST_EQ( tallied<true>::moves, 1 );
+
+    std::string const   text( 100u, 'm' );
+    nothrow_union       s{ text };
+    char const * const  buffer = gett<std::string>( s ).data();
+
+    target = std::move( s );
+    BOOST_TEST_EQ( gett<std::string>(target), text );
+    BOOST_TEST_EQ( gett<std::string>(target).data(), buffer );  // stolen
+
+    // Reallocation moves the elements when it can
+    std::vector<nothrow_union>   v;
+    std::vector<throwing_union>  w;
+
+    for ( int  i = 0 ; i < 100 ; ++i )
+    {
+        v.emplace_back( tallied<true>{i} );
+        w.emplace_back( tallied<false>{i} );
+    }
+    BOOST_TEST_EQ( tallied<true>::copies, 0 );
+    BOOST_TEST( tallied<false>::copies > 0 );
+    BOOST_TEST_EQ( gett<tallied<true>>(v.back()).value, 99 );
+}
+
+// Unions convert to ones with more types, and back (explicitly) while the
+// type fits
+void  test_conversions()
+{
+    typedef boost::unions::tagged_union<std::string, tallied<true>>  narrow;
+    typedef boost::unions::tagged_union<int, tallied<true>, double,
+     std::string>  wide;
+
+    static_assert( std::is_convertible<narrow, wide>::value, "" );
+    static_assert( !std::is_convertible<wide, narrow>::value, "" );
+    static_assert( std::is_constructible<narrow, wide const &>::value, "" );
+    static_assert( std::is_constructible<narrow, wide &&>::value, "" );
+    static_assert( !std::is_assignable<narrow &, wide const &>::value, "" );
+    static_assert( std::is_assignable<wide &, narrow const &>::value, "" );
+    static_assert( !std::is_convertible<boost::unions::tagged_union<int,
+     char>, boost::unions::tagged_union<int, double>>::value, "" );
+
+    narrow const  n{ std::string("widen") };
+    wide          w{ n }, e{ narrow{} };
+
+    BOOST_TEST_EQ( w.stored_index(), 3u );
+    BOOST_TEST_EQ( gett<std::string>(w), "widen" );
+    BOOST_TEST_EQ( e.stored_index(), wide::empty_index() );
+
+    // Moves move the object across
+    tallied<true>::copies = tallied<true>::moves = 0;
+    w = narrow{ tallied<true>{6} };
+    BOOST_TEST_EQ( w.stored_index(), 1u );
+    BOOST_TEST_EQ( gett<tallied<true>>(w).value, 6 );
+    BOOST_TEST_EQ( tallied<true>::copies, 0 );
+
+    narrow  m{ std::move(w) };
+
+    BOOST_TEST_EQ( m.stored_index(), 1u );
+    BOOST_TEST_EQ( gett<tallied<true>>(m).value, 6 );
+    BOOST_TEST_EQ( tallied<true>::copies, 0 );
+
+    // Narrowing checks the stored type, and failure changes nothing
+    w = 2.5;
+    BOOST_TEST_THROWS( (narrow{ w }), boost::bad_get );
+    BOOST_TEST_THROWS( m = narrow(w), boost::bad_get );
+    BOOST_TEST_EQ( gett<tallied<true>>(m).value, 6 );
+    w = n;
+    m = narrow( w );
+    BOOST_TEST_EQ( gett<std::string>(m), "widen" );
+
+    wide const  s{ static_cast<wide const *>(&w) };
+
+    BOOST_TEST_THROWS( m = narrow(s), boost::bad_get );
+    m = narrow( wide{} );
+    BOOST_TEST_EQ( m.stored_index(), narrow::empty_index() );
+
+    // The same types with another policy convert too
+    boost::unions::basic_tagged_union<boost::unions::cache_line_union_policy,
+     std::string, tallied<true>>  c{ n };
+
+    BOOST_TEST_EQ( gett<std::string>(c), "widen" );
+}
+
+// A visitor that records what it's given, in order
+struct recorder
+{
+    std::string  log;
+
+    void  operator ()( int &x )  { log += 'i' + std::to_string( x++ ); }
+    void  operator ()( int const &x )  { log += 'c' + std::to_string( x ); }
+    void  operator ()( double x )  { log += 'd' + std::to_string( int(x) ); }
+    void  operator ()( std::string const &x )  { log += 's' + x; }
+};
+
+// A visitor that counts what it's given
+struct counter
+{
+    std::size_t  calls = 0u;
+
+    template < typename T >
+    void  operator ()( T const & )  { ++calls; }
+};
+
+// Range visits go one type at a time, in order within each type
+void  test_visit_range()
+{
+    typedef boost::unions::tagged_union<int, double, std::string>  ids_union;
+
+    ids_union const               self_target{ 0 };
+    std::vector<ids_union>        v;
+    std::vector<ids_union> const  &c = v;
+
+    v.emplace_back( 1 );
+    v.emplace_back( std::string("a") );
+    v.emplace_back( 2.0 );
+    v.emplace_back();
+    v.emplace_back( 3 );
+    v.emplace_back( &self_target );
+    v.emplace_back( std::string("b") );
+    v.emplace_back( 4.0 );
+
+    recorder  r;
+
+    boost::unions::visit_range( v.begin(), v.end(), r );
+    BOOST_TEST_EQ( r.log, "i1i3d2d4sasb" );
+    BOOST_TEST_EQ( gett<int>(v[4u]), 4 );  // members are passed by reference
+
+    boost::unions::visit_range( c.begin(), c.end(), r, 2u );
+    BOOST_TEST_EQ( r.log, "i1i3d2d4sasbc2c4d2d4sasb" );
+
+    // Runs of one type get one loop each; any order still works
+    counter  n;
+
+    r.log.clear();
+    boost::unions::visit_runs( v.begin(), v.end(), r );
+    BOOST_TEST_EQ( r.log, "i2sad2i4sbd4" );
+
+    std::stable_sort( v.begin(), v.end(), []( ids_union const &a, ids_union
+     const &b ){ return a.stored_index() < b.stored_index(); } );
+    r.log.clear();
+    boost::unions::visit_runs( c.begin(), c.end(), r );
+    BOOST_TEST_EQ( r.log, "c3c5d2d4sasb" );
+
+    boost::unions::visit_range( v.begin(), v.begin(), r );
+    boost::unions::visit_runs( v.begin(), v.begin(), n );
+    BOOST_TEST_EQ( n.calls, 0u );
+}
+
+// An allocator that keeps count of the objects it has out
+int  boxes_out = 0;
+
+template < typename T >
+struct tallying_allocator
+{
+    typedef T  value_type;
+
+    tallying_allocator() = default;
+    template < typename U >
+    tallying_allocator( tallying_allocator<U> const & )  {}
+
+    T *  allocate( std::size_t n )
+    {
+        ++boxes_out;
+        return static_cast<T *>( ::operator new(n * sizeof( T )) );
+    }
+    void  deallocate( T *p, std::size_t )
+    {
+        --boxes_out;
+        ::operator delete( p );
+    }
+};
+
+template < typename T, typename U >
+bool  operator ==( tallying_allocator<T> const &, tallying_allocator<U> const
+ & )
+{ return true; }
+template < typename T, typename U >
+bool  operator !=( tallying_allocator<T> const &, tallying_allocator<U> const
+ & )
+{ return false; }
+
+// A rare, large alternative
+struct bulky
+{
+    counted<0>  tally;
+    char        padding[ 1000 ];
+
+    explicit  bulky( int v, bool fail = false ) : tally( v ), padding()
+    { if ( fail ) throw 0; }
+};
+
+// Types past the inline limit live on the heap, behind one pointer
+void  test_boxing()
+{
+    typedef boost::unions::small_buffer_union_policy<16u,
+     tallying_allocator<char>>  boxing_policy;
+    typedef boost::unions::basic_tagged_union<boxing_policy, int, double,
+     bulky>  boxing_union;
+    typedef boost::unions::tagged_union<int, double, bulky>  inline_union;
+
+    static_assert( sizeof(boxing_union) <= 2u * sizeof(double), "" );
+    static_assert( sizeof(inline_union) > sizeof(bulky), "" );
+    static_assert( std::is_nothrow_move_constructible<boxing_union>::value,
+     "" );
+    static_assert( !std::is_nothrow_constructible<boxing_union, bulky &&>::
+     value, "" );
+    static_assert( std::is_nothrow_constructible<boxing_union, int>::value,
+     "" );
+
+    {
+        boxing_union        a{ bulky{1} };
+        bulky const * const p = gett<bulky>( &a );
+
+        BOOST_TEST_EQ( boxes_out, 1 );
+        BOOST_TEST( p && p->tally.value == 1 );
+        BOOST_TEST( static_cast<void const *>(p) != &a );
+
+        // Copies get their own box; moves take the box, leaving nothing
+        boxing_union  b{ a };
+        boxing_union  c{ std::move(a) };
+
+        BOOST_TEST_EQ( boxes_out, 2 );
+        BOOST_TEST( gett<bulky>(&b) != p );
+        BOOST_TEST_EQ( gett<bulky>(b).tally.value, 1 );
+        BOOST_TEST_EQ( gett<bulky>(&c), p );
+        BOOST_TEST_EQ( a.stored_index(), boxing_union::empty_index() );
+
+        b = 5;
+        BOOST_TEST_EQ( boxes_out, 1 );
+        BOOST_TEST_EQ( gett<int>(b), 5 );
+        b = c;
+        BOOST_TEST_EQ( boxes_out, 2 );
+        b = std::move( c );
+        BOOST_TEST_EQ( boxes_out, 1 );
+        BOOST_TEST_EQ( gett<bulky>(&b), p );
+        BOOST_TEST( !c.data() );
+
+        BOOST_TEST_EQ( b.emplace<bulky>(7).tally.value, 7 );
+        BOOST_TEST_EQ( boxes_out, 1 );
+        c = 2.5;
+        try {
+            c.emplace<bulky>( 8, true );
+        } catch ( int ) {
+        }
+        BOOST_TEST_EQ( boxes_out, 1 );
+        BOOST_TEST_EQ( gett<double>(c), 2.5 );
+
+        swap( b, c );
+        BOOST_TEST_EQ( gett<bulky>(c).tally.value, 7 );
+        BOOST_TEST_EQ( gett<double>(b), 2.5 );
+
+        // Growing a vector moves the boxes, not what's in them
+        std::vector<boxing_union>  v;
+
+        for ( int  i = 0 ; i < 50 ; ++i )
+            v.emplace_back( boost::unions::in_place_type_t<bulky>{}, i );
+        BOOST_TEST_EQ( boxes_out, 51 );
+        BOOST_TEST_EQ( counted<0>::live, 51 );
+        BOOST_TEST_EQ( gett<bulky>(v[ 49 ]).tally.value, 49 );
+
+        // Conversions box and unbox as needed
+        inline_union        d{ c };
+        boxing_union const  e{ d };
+
+        BOOST_TEST_EQ( boxes_out, 52 );
+        BOOST_TEST_EQ( gett<bulky>(d).tally.value, 7 );
+        BOOST_TEST_EQ( gett<bulky>(e).tally.value, 7 );
+        d = std::move( v[0] );
+        BOOST_TEST_EQ( gett<bulky>(d).tally.value, 0 );
+        BOOST_TEST_EQ( boxes_out, 52 );
+    }
+    BOOST_TEST_EQ( boxes_out, 0 );
+    BOOST_TEST_EQ( counted<0>::live, 0 );
+}
+
+
+// Main program
+int  main()
+{
+    test_alternative_indices();
+    test_special_members();
+    test_pointer_to_self();
+    test_compact_tag();
+    test_visit();
+    test_triviality();
+    test_alignment();
+    test_swap();
+    test_guarantees();
+    test_emplace();
+    test_moves();
+    test_conversions();
+    test_visit_range();
+    test_boxing();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,174 @@
+//  Boost Unions Library, tagged_union_view run-time test file  --------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union_view.hpp"  // for ...::tagged_union_view
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <cstring>   // for std::memcpy
+#include <typeinfo>  // for typeid
+#include <vector>    // for std::vector
+
+
+struct trade
+{
+    double  price;
+    int     size;
+};
+
+typedef boost::unions::tagged_union<char, double, trade>  record;
+typedef boost::unions::tagged_union_view<char, double, trade>  record_view;
+
+using boost::unions::binary_reader;
+using boost::unions::binary_writer;
+using boost::unions::gett;
+
+// Sums what it's given, counting the calls
+struct summer
+{
+    double  sum;
+    int     calls;
+
+    void  operator ()( char c )  { sum += c; ++calls; }
+    void  operator ()( double const &d )  { sum += d; ++calls; }
+    void  operator ()( trade const &t )  { sum += t.price * t.size; ++calls; }
+};
+
+
+// A run of records, viewed one by one where they lie
+void  test_views()
+{
+    std::vector<record>  records{ record{'a'}, record{2.5},
+     record{trade{10.0, 3}}, record{}, record{trade{1.0, 1}} };
+    std::vector<unsigned char>  bytes;
+    binary_writer               w{ bytes };
+
+    boost::unions::save( w, records );
+
+    binary_reader  r{ bytes };
+    std::uint64_t  count;
+    summer         s{ 0.0, 0 };
+    std::size_t    aligned = 0u, unaligned = 0u;
+
+    r.read( &count, sizeof(count) );
+    BOOST_TEST_EQ( count, records.size() );
+    for ( std::size_t  i = 0u ; i < count ; ++i )
+    {
+        record_view const  v{ r };
+
+        BOOST_TEST_EQ( v.stored_index(), (records[i].stored_index() ==
+         records[i].empty_index()) ? v.empty_index() :
+         records[i].stored_index() );
+        BOOST_TEST( v.stored_type() == records[i].stored_type() ||
+         *v.stored_type() == *records[i].stored_type() );
+        if ( v.stored_index() != v.empty_index() )
+            boost::unions::visit( s, v );
+        else
+            BOOST_TEST_THROWS( boost::unions::visit(s, v), boost::bad_get );
+
+        // Pointers are given only when the bytes are aligned; copies always
+        if ( v.stored_index() == v.index_of<trade>() )
+        {
+            trade const  t = gett<trade>( v );
+
+            BOOST_TEST_EQ( t.price, gett<trade>(records[i]).price );
+            if ( trade const * const  p = gett<trade>(&v) )
+            {
+                BOOST_TEST_EQ( p->size, t.size );
+                ++aligned;
+            }
+            else
+            {
+                BOOST_TEST( !v.aligned() );
+                ++unaligned;
+            }
+        }
+        BOOST_TEST( !gett<double>(&v) || v.stored_index() == 1u );
+    }
+    BOOST_TEST_EQ( r.remaining(), 0u );
+    BOOST_TEST_EQ( s.calls, 4 );
+    BOOST_TEST_EQ( s.sum, 'a' + 2.5 + 30.0 + 1.0 );
+    BOOST_TEST_EQ( aligned + unaligned, 2u );
+
+    // The wrong type, and a null view
+    record_view const  first{ bytes.data() + sizeof(count), bytes.data() +
+     bytes.size() };
+
+    BOOST_TEST_EQ( first.size(), 2u );
+    BOOST_TEST( first.end() == bytes.data() + sizeof(count) + 2u );
+    BOOST_TEST_EQ( gett<char>(first), 'a' );
+    BOOST_TEST_THROWS( gett<double>(first), boost::bad_get );
+    BOOST_TEST( !gett<char>(static_cast<record_view const *>( nullptr )) );
+}
+
+// Aligned bytes are read in place
+void  test_in_place()
+{
+    union
+    {
+        double         align;
+        unsigned char  bytes[ 24 ];
+    }  buffer;
+
+    // Index at the end of the first double, so the member is aligned
+    double const  value = 6.25;
+
+    buffer.bytes[ 7 ] = 1u;
+    std::memcpy( buffer.bytes + 8, &value, sizeof(value) );
+
+    record_view const  v{ buffer.bytes + 7, buffer.bytes + 16 };
+
+    BOOST_TEST( v.aligned() );
+    BOOST_TEST( gett<double>(&v) == reinterpret_cast<double const *>(
+     buffer.bytes + 8) );
+    BOOST_TEST_EQ( *gett<double>(&v), 6.25 );
+    BOOST_TEST( *v.stored_type() == typeid(double) );
+
+    // One byte over, and it's copied instead
+    buffer.bytes[ 8 ] = 1u;
+    std::memcpy( buffer.bytes + 9, &value, sizeof(value) );
+
+    record_view const  u{ buffer.bytes + 8, buffer.bytes + 17 };
+
+    BOOST_TEST( !u.aligned() );
+    BOOST_TEST( !gett<double>(&u) );
+    BOOST_TEST_EQ( gett<double>(u), 6.25 );
+}
+
+// Short buffers and bad indices are refused
+void  test_bad_input()
+{
+    unsigned char const  bytes[] = { 2u, 0u, 3u, 7u };
+
+    BOOST_TEST_THROWS( record_view(bytes, bytes),
+     boost::unions::archive_error );
+    BOOST_TEST_THROWS( record_view(bytes, bytes + 4),
+     boost::unions::archive_error );
+    BOOST_TEST_THROWS( record_view(bytes + 3, bytes + 4),
+     boost::unions::archive_error );
+
+    record_view const  empty{ bytes + 2, bytes + 3 };
+
+    BOOST_TEST_EQ( empty.size(), 1u );
+    BOOST_TEST( !empty.stored_type() );
+    BOOST_TEST( !empty.data() );
+    BOOST_TEST( !empty.aligned() );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_views();
+    test_in_place();
+    test_bad_input();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,310 @@
+//  Boost Unions Library, union archive run-time test file  ------------------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/union_archive.hpp"  // for boost::unions::save, etc.
+#include "boost/unions/union_policy.hpp"   // for ...::small_buffer_union_policy
+
+#include <boost/core/lightweight_test.hpp>  // for BOOST_TEST, etc.
+
+#include <algorithm>  // for std::find
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint64_t
+#include <iterator>   // for std::begin, end
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+
+
+// A type that isn't trivially copyable, with its own codec
+struct name_list
+{
+    std::vector<std::string>  names;
+};
+
+bool  operator ==( name_list const &a, name_list const &b )
+{ return a.names == b.names; }
+
+namespace boost
+{
+namespace unions
+{
+    template < >
+    struct member_codec< name_list >
+    {
+        static  void  save( binary_writer &w, name_list const &x )
+        {
+            w.write( "L", 1u );
+            for ( std::string const &n : x.names )
+                member_codec<std::string>::save( w, n );
+            member_codec<std::string>::save( w, std::string{} );
+        }
+        static  auto  load( binary_reader &r ) -> name_list
+        {
+            name_list  result;
+
+            if ( *r.take(1u) != 'L' )
+                throw archive_error{ "not a name list" };
+            for ( std::string  n ; !(n = member_codec<std::string>::load( r ))
+             .empty() ; )
+                result.names.push_back( n );
+            return result;
+        }
+    };
+}
+}
+
+// A pointer into a fixed table, saved as its place in the table
+char const * const  colors[] = { "red", "green", "blue" };
+
+namespace boost
+{
+namespace unions
+{
+    template < >
+    struct member_codec< char const * >
+    {
+        static  void  save( binary_writer &w, char const *x )
+        {
+            unsigned char const  i = static_cast<unsigned char>( std::find(
+             std::begin(colors), std::end(colors), x ) - std::begin(colors) );
+
+            w.write( &i, 1u );
+        }
+        static  auto  load( binary_reader &r ) -> char const *
+        {
+            unsigned char const  i = *r.take( 1u );
+
+            if ( i >= 3u )
+                throw archive_error{ "not a color" };
+            return colors[ i ];
+        }
+    };
+}
+}
+
+struct point
+{
+    float  x, y;
+};
+
+bool  operator ==( point const &a, point const &b )
+{ return a.x == b.x && a.y == b.y; }
+
+struct wide
+{
+    double  d[ 4 ];
+};
+
+bool  operator ==( wide const &a, wide const &b )
+{ return a.d[0] == b.d[0] && a.d[3] == b.d[3]; }
+
+// Whether two unions have the same state
+struct same_member
+{
+    template < typename T, typename U >
+    bool  operator ()( T const &, U const & ) const  { return false; }
+    template < typename T >
+    bool  operator ()( T const &a, T const &b ) const  { return a == b; }
+};
+
+template < class Union >
+bool  same( Union const &a, Union const &b )
+{
+    return ( a.stored_index() == b.stored_index() ) && ( a.stored_index() ==
+     a.empty_index() || boost::unions::visit(same_member{}, a, b) );
+}
+
+template < class Union >
+bool  same( std::vector<Union> const &a, std::vector<Union> const &b )
+{
+    bool  result = a.size() == b.size();
+
+    for ( std::size_t  i = 0u ; result && i < a.size() ; ++i )
+        result = same( a[i], b[i] );
+    return result;
+}
+
+typedef boost::unions::tagged_union<int, double, point>  plain_union;
+typedef boost::unions::tagged_union<int, std::string, name_list>  rich_union;
+typedef boost::unions::tagged_union<int, char const *>  color_union;
+
+using boost::unions::binary_reader;
+using boost::unions::binary_writer;
+using boost::unions::gett;
+
+
+// Each state, and the bytes it takes
+void  test_tagged_union()
+{
+    std::vector<unsigned char>  bytes;
+    binary_writer               w{ bytes };
+
+    boost::unions::save( w, plain_union{3} );
+    BOOST_TEST_EQ( bytes.size(), 1u + sizeof(int) );
+    boost::unions::save( w, plain_union{point{1.5f, -2.0f}} );
+    BOOST_TEST_EQ( bytes.size(), 2u + sizeof(int) + sizeof(point) );
+    boost::unions::save( w, plain_union{} );
+    BOOST_TEST_EQ( bytes.size(), 3u + sizeof(int) + sizeof(point) );
+    BOOST_TEST_EQ( bytes.back(), 3u );
+    boost::unions::save( w, rich_union{std::string{"hello"}} );
+    boost::unions::save( w, rich_union{name_list{ {"a", "bc"} }} );
+
+    binary_reader  r{ bytes };
+    plain_union    p{ 2.5 };
+    rich_union     q;
+
+    boost::unions::load( r, p );
+    BOOST_TEST( gett<int>(&p) && *gett<int>(&p) == 3 );
+    boost::unions::load( r, p );
+    BOOST_TEST( gett<point>(&p) && gett<point>(&p)->y == -2.0f );
+    boost::unions::load( r, p );
+    BOOST_TEST_EQ( p.stored_index(), p.empty_index() );
+    boost::unions::load( r, q );
+    BOOST_TEST( gett<std::string>(&q) && *gett<std::string>(&q) == "hello" );
+    boost::unions::load( r, q );
+    BOOST_TEST( gett<name_list>(&q) && gett<name_list>(&q)->names ==
+     std::vector<std::string>({"a", "bc"}) );
+    BOOST_TEST_EQ( r.remaining(), 0u );
+
+    // Bad input
+    BOOST_TEST_THROWS( boost::unions::load(r, p),
+     boost::unions::archive_error );
+
+    unsigned char const  bad_index[] = { 4u, 0u, 0u, 0u, 0u };
+    binary_reader        r2{ bad_index, bad_index + 5 };
+
+    BOOST_TEST_THROWS( boost::unions::load(r2, p),
+     boost::unions::archive_error );
+
+    unsigned char const  short_int[] = { 0u, 1u, 2u };
+    binary_reader        r3{ short_int, short_int + 3 };
+
+    BOOST_TEST_THROWS( boost::unions::load(r3, p),
+     boost::unions::archive_error );
+
+    // Pointers-to-self mean nothing outside this run
+    plain_union const  self{ &p };
+
+    BOOST_TEST_THROWS( boost::unions::save(w, self), boost::bad_get );
+}
+
+// The caller says which member is active
+void  test_super_union()
+{
+    typedef boost::unions::super_union<int, double, std::uint64_t>  raw_union;
+
+    std::vector<unsigned char>  bytes;
+    binary_writer               w{ bytes };
+    raw_union                   u;
+
+    boost::unions::get<1>( u ) = 0.25;
+    boost::unions::save( w, u, 1u );
+    BOOST_TEST_EQ( bytes.size(), 1u + sizeof(double) );
+    BOOST_TEST_THROWS( boost::unions::save(w, u, 3u), std::out_of_range );
+
+    binary_reader  r{ bytes };
+    raw_union      v;
+
+    BOOST_TEST_EQ( boost::unions::load(r, v), 1u );
+    BOOST_TEST_EQ( boost::unions::get<1>(v), 0.25 );
+}
+
+// Whole vectors, by byte copies and by codec
+template < class Union >
+void  check_round_trip( std::vector<Union> const &v )
+{
+    std::vector<unsigned char>  bytes;
+    binary_writer               w{ bytes };
+
+    boost::unions::save( w, v );
+
+    std::vector<Union>  out{ Union{} };
+    binary_reader       r{ bytes };
+
+    boost::unions::load( r, out );
+    BOOST_TEST_EQ( r.remaining(), 0u );
+    BOOST_TEST( same(out, v) );
+
+    // Element-by-element writing makes the same bytes
+    std::vector<unsigned char>  bytes2;
+    binary_writer               w2{ bytes2 };
+    std::uint64_t const         count = v.size();
+
+    w2.write( &count, sizeof(count) );
+    for ( Union const &u : v )
+        boost::unions::save( w2, u );
+    BOOST_TEST( bytes2 == bytes );
+
+    // Any cut is caught
+    for ( std::size_t  n = 0u ; n < bytes.size() ; n += 7u )
+    {
+        binary_reader  cut{ bytes.data(), bytes.data() + n };
+
+        BOOST_TEST_THROWS( boost::unions::load(cut, out),
+         boost::unions::archive_error );
+    }
+}
+
+void  test_vectors()
+{
+    std::vector<plain_union>  plain;
+
+    for ( int  i = 0 ; i < 100 ; ++i )
+        if ( i % 3 == 0 )
+            plain.emplace_back( i );
+        else if ( i % 3 == 1 )
+            plain.emplace_back( i * 0.5 );
+        else if ( i % 10 == 2 )
+            plain.emplace_back();
+        else
+            plain.emplace_back( point{1.0f * i, -1.0f * i} );
+    check_round_trip( plain );
+    check_round_trip( std::vector<plain_union>{} );
+
+    std::vector<rich_union>  rich;
+
+    for ( int  i = 0 ; i < 30 ; ++i )
+        if ( i % 2 )
+            rich.emplace_back( i );
+        else
+            rich.emplace_back( std::string(i, 'x') );
+    check_round_trip( rich );
+
+    // Pointers go through their codec, not as addresses
+    std::vector<color_union>  hues;
+
+    for ( int  i = 0 ; i < 12 ; ++i )
+        if ( i % 4 )
+            hues.emplace_back( colors[i % 3] );
+        else
+            hues.emplace_back( i );
+    check_round_trip( hues );
+
+    // Boxed members are saved by value
+    typedef boost::unions::basic_tagged_union<
+     boost::unions::small_buffer_union_policy<8u>, int, point, wide>
+      boxed_union;
+
+    std::vector<boxed_union>  boxed;
+
+    boxed.emplace_back( 7 );
+    boxed.emplace_back( point{2.0f, 3.0f} );
+    boxed.emplace_back( wide{ {1.0, 2.0, 3.0, 4.0} } );
+    boxed.emplace_back();
+    check_round_trip( boxed );
+}
+
+
+// Main program, executing all the tests
+int  main()
+{
+    test_tagged_union();
+    test_super_union();
+    test_vectors();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,34 @@
+//  Boost Unions Library, visit_range compile-time-fail test file  -----------//
+
+//  Copyright 2012 Daryle Walker.  Use, modification, and distribution are
+//  subject to the Boost Software License, Version 1.0.  (See accompanying file
+//  LICENSE_1_0.txt or a copy at <http://www.boost.org/LICENSE_1_0.txt>.)
+
+//  See <http://www.boost.org/libs/unions/> for the library's home page.
+
+#include "boost/unions/tagged_union.hpp"  // for ...::visit_range, visit_runs
+
+#include <string>  // for std::string
+#include <vector>  // for std::vector
+
+
+// The union we'll be working with...
+typedef boost::unions::tagged_union<int, std::string>  intstring_t;
+
+// ...And a visitor that misses one of its variant types.
+struct strings_only
+{
+    void  operator ()( std::string const & ) const  { }
+};
+
+
+// Main program
+int  main()
+{
+    std::vector<intstring_t>  v( 3u );
+
+    boost::unions::visit_range( v.begin(), v.end(), strings_only{} );  // fails
+    boost::unions::visit_runs( v.begin(), v.end(), strings_only{} );   // fails
+
+    return 0;
+}